@@ -0,0 +1,48 @@
+#ifndef _BYTECODE_H
+#define _BYTECODE_H
+#include <stdint.h>
+
+// The binary (bytecode) format for programs, an alternative
+// to the VM's text format that can be loaded without parsing.
+// (vm/bytecode.h describes the same format for the VM.)
+//
+// A bytecode file consists of
+//  - a header (bytecode_header),
+//  - num_instrs instructions, each two 32-bit integers (op, then M),
+//    starting at offset header_size,
+//  - num_sections optional sections, each a bytecode_section
+//    followed by its data, padded with zeros to a multiple of 4 bytes.
+// All integers are in the byte order of the machine that
+// wrote the file; a file from a machine with the other byte order
+// is rejected because its magic number and version do not match.
+// Sections with unknown tags are skipped, so new kinds of sections
+// can be added without changing the version.
+
+// the first 4 bytes of each bytecode file
+#define BYTECODE_MAGIC "PL0B"
+#define BYTECODE_MAGIC_SIZE 4
+
+// the version of the format described above
+#define BYTECODE_VERSION 1
+
+typedef struct {
+    char magic[BYTECODE_MAGIC_SIZE]; // BYTECODE_MAGIC (not 0 terminated)
+    uint32_t version;      // BYTECODE_VERSION
+    uint32_t header_size;  // size of the header in bytes
+    uint32_t num_instrs;   // number of instructions
+    uint32_t entry;        // address of the first instruction to execute
+    uint32_t num_sections; // number of sections after the instructions
+} bytecode_header;
+
+// the tags of the known sections
+// the name of the source file the program was compiled from
+#define BYTECODE_SECTION_SOURCE 1
+
+typedef struct {
+    uint32_t tag;    // what the section holds
+    uint32_t length; // length of the data in bytes (without padding)
+} bytecode_section;
+
+// the size of each instruction in a bytecode file
+#define BYTECODE_INSTR_SIZE (2 * sizeof(int32_t))
+#endif
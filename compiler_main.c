@@ -1,126 +1,186 @@
-// By: Vincent Lazo ad Christian Manuel
-/* $Id: compiler_main.c,v 1.11 2023/03/23 02:57:55 leavens Exp $ */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "lexer_output.h"
-#include "parser.h"
-#include "ast.h"
-#include "symtab.h"
-#include "scope_check.h"
-#include "utilities.h"
-#include "unparser.h"
-#include "code.h"
-#include "gen_code.h"
-
-/* Print a usage message on stderr 
-   and exit with failure. */
-static void usage(const char *cmdname)
-{
-    fprintf(stderr, "Usage: %s %s\n       %s %s\n       %s %s\n",
-	    cmdname, "-l codeFilename.pl0",
-	    cmdname, "-u codeFilename.pl0",
-	    cmdname, " codeFilename.pl0"
-	    );
-    exit(EXIT_FAILURE);
-}
-
-int main(int argc, char *argv[])
-{
-    // should the lexer's tokens be shown
-    bool lexer_print_output = false;
-    bool parser_unparse = false;
-    /* bool debug_asm = false; */
-    const char *cmdname = argv[0];
-    argc--;
-    argv++;
-    // possible options: -l, -d, and -u
-    while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-')
-	{
-		if (strcmp(argv[0],"-l") == 0)
-		{
-			lexer_print_output = true;
-			argc--;
-			argv++;
-			/*} else if (strcmp(argv[0],"-d") == 0) {
-			debug_asm = true;
-			argc--;
-			argv++; */
-		}
-		else if (strcmp(argv[0],"-u") == 0)
-		{
-			parser_unparse = true;
-			argc--;
-			argv++;
-		}
-		else
-		{
-			// bad option!
-			usage(cmdname);
-		}
-    }
-
-    // give usage message if -l and other options are used
-    if (lexer_print_output && /* (debug_asm || */ parser_unparse/*)*/ )
-	{
-		usage(cmdname);
-    }
-
-    /*
-    // give usage message if -u and -d are both used
-    if (parser_unparse && debug_asm) {
-	usage(cmdname);
-    }
-    */
-
-    // must have a file name
-    if (argc <= 0 || (strlen(argv[0]) >= 2 && argv[0][0] == '-'))
-	{
-		usage(cmdname);
-    }
-
-    // the name of the file
-    const char *filename = argv[0];
-
-    if (lexer_print_output)
-	{
-		// with the lexer_print_output option, nothing else is done
-		lexer_open(filename);
-		lexer_output();
-		lexer_close();
-		return EXIT_SUCCESS;
-    }
-
-    // otherwise (if not lexer_print_outout) continue to parse etc.
-    parser_open(filename);
-    AST * progast = parseProgram();
-    parser_close();
-
-    if (parser_unparse)
-	{
-		unparseProgram(stdout, progast);
-    }
-
-    // build symbol table and...
-    symtab_initialize();
-    // check for duplicate declarations and proper use of names
-    // this modifies progast
-    scope_check_program(progast);
-
-    if (parser_unparse)
-	{
-		return EXIT_SUCCESS;
-    }
-
-    // generate code from the ASTs
-    gen_code_initialize();
-    code_seq prog_code_seq = gen_code_program(progast);
-
-    /* if (debug_asm) {
-    	code_seq_debug_print(stdout, prog_code_seq);
-       } else { */
-    code_seq_vm_print(stdout, prog_code_seq);
-    /* } */
-
-    return EXIT_SUCCESS;
-}
+// By: Vincent Lazo ad Christian Manuel
+/* $Id: compiler_main.c,v 1.11 2023/03/23 02:57:55 leavens Exp $ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lexer_output.h"
+#include "parser.h"
+#include "ast.h"
+#include "symtab.h"
+#include "scope_check.h"
+#include "utilities.h"
+#include "unparser.h"
+#include "code.h"
+#include "gen_code.h"
+
+/* Print a usage message on stderr 
+   and exit with failure. */
+static void usage(const char *cmdname)
+{
+    fprintf(stderr, "Usage: %s %s\n       %s %s\n       %s %s\n       %s %s\n",
+	    cmdname, "-l codeFilename.pl0",
+	    cmdname, "-T codeFilename.pl0",
+	    cmdname, "-u codeFilename.pl0",
+	    cmdname, "[-b] [-D] [-S] codeFilename.pl0"
+	    );
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+    // should the lexer's tokens be shown
+    bool lexer_print_output = false;
+    // should the lexer only be timed
+    bool lexer_time_only = false;
+    bool parser_unparse = false;
+    // should the code be written in the VM's bytecode format
+    bool emit_bytecode = false;
+    // should non-local variables be reached through the VM's display
+    bool use_display = false;
+    // should static links be left out of frames that do not need them
+    bool skip_static_links = false;
+    /* bool debug_asm = false; */
+    const char *cmdname = argv[0];
+    argc--;
+    argv++;
+    // possible options: -l, -T, -d, -u, -b, -D, and -S
+    while (argc > 0 && strlen(argv[0]) >= 2 && argv[0][0] == '-')
+	{
+		if (strcmp(argv[0],"-l") == 0)
+		{
+			lexer_print_output = true;
+			argc--;
+			argv++;
+			/*} else if (strcmp(argv[0],"-d") == 0) {
+			debug_asm = true;
+			argc--;
+			argv++; */
+		}
+		else if (strcmp(argv[0],"-T") == 0)
+		{
+			lexer_time_only = true;
+			argc--;
+			argv++;
+		}
+		else if (strcmp(argv[0],"-u") == 0)
+		{
+			parser_unparse = true;
+			argc--;
+			argv++;
+		}
+		else if (strcmp(argv[0],"-b") == 0)
+		{
+			emit_bytecode = true;
+			argc--;
+			argv++;
+		}
+		else if (strcmp(argv[0],"-D") == 0)
+		{
+			use_display = true;
+			argc--;
+			argv++;
+		}
+		else if (strcmp(argv[0],"-S") == 0)
+		{
+			skip_static_links = true;
+			argc--;
+			argv++;
+		}
+		else
+		{
+			// bad option!
+			usage(cmdname);
+		}
+    }
+
+    // give usage message if -l or -T and other options are used
+    if (lexer_print_output + lexer_time_only
+	+ /* debug_asm + */ parser_unparse > 1)
+	{
+		usage(cmdname);
+    }
+
+    // -b, -D, and -S only apply when code is generated
+    if ((emit_bytecode || use_display || skip_static_links)
+	&& (lexer_print_output || lexer_time_only || parser_unparse))
+	{
+		usage(cmdname);
+    }
+
+    /*
+    // give usage message if -u and -d are both used
+    if (parser_unparse && debug_asm) {
+	usage(cmdname);
+    }
+    */
+
+    // must have a file name
+    if (argc <= 0 || (strlen(argv[0]) >= 2 && argv[0][0] == '-'))
+	{
+		usage(cmdname);
+    }
+
+    // the name of the file
+    const char *filename = argv[0];
+
+    if (lexer_print_output)
+	{
+		// with the lexer_print_output option, nothing else is done
+		token_array tokens;
+		lexer_tokenize(filename, &tokens);
+		lexer_output(&tokens);
+		token_array_free(&tokens);
+		return EXIT_SUCCESS;
+    }
+
+    if (lexer_time_only)
+	{
+		// with the lexer_time_only option, the tokens are only counted
+		lexer_open(filename);
+		lexer_benchmark();
+		lexer_close();
+		return EXIT_SUCCESS;
+    }
+
+    // otherwise (if not lexer_print_outout) continue to parse etc.
+    parser_open(filename);
+    AST * progast = parseProgram();
+    parser_close();
+
+    if (parser_unparse)
+	{
+		unparseProgram(stdout, progast);
+    }
+
+    // build symbol table and...
+    symtab_initialize();
+    // check for duplicate declarations and proper use of names
+    // this modifies progast
+    scope_check_program(progast);
+
+    if (parser_unparse)
+	{
+		return EXIT_SUCCESS;
+    }
+
+    // generate code from the ASTs
+    gen_code_initialize();
+    gen_code_set_display(use_display);
+    gen_code_set_skip_static_links(skip_static_links);
+    code_seq prog_code_seq = gen_code_program(progast);
+
+    /* if (debug_asm) {
+    	code_seq_debug_print(stdout, prog_code_seq);
+       } else { */
+    if (emit_bytecode)
+	{
+		code_seq_bytecode_print(stdout, prog_code_seq, filename);
+	}
+    else
+	{
+		code_seq_vm_print(stdout, prog_code_seq);
+	}
+    /* } */
+
+    return EXIT_SUCCESS;
+}
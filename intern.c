@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "utilities.h"
+#include "intern.h"
+
+// The table is open addressed (with linear probing) over the names'
+// characters; it is kept at most half full, so probes are short.
+// The names' characters are stored in large chunks, not allocated
+// one by one, and the chunks are never moved, so the pointers
+// returned stay valid as the table grows.
+
+// the initial number of slots (a power of 2)
+#define INTERN_INITIAL_SLOTS 256
+// the size of a chunk of characters (a longer name gets its own chunk)
+#define INTERN_CHUNK_SIZE 8192
+
+// a slot of the table (empty if name is NULL)
+typedef struct {
+    const char *name;
+    size_t length;
+    uint32_t hash;
+} intern_slot;
+
+static intern_slot *slots = NULL;
+// the number of slots (a power of 2) and of names in them
+static size_t num_slots = 0;
+static unsigned int num_names = 0;
+
+// the free space of the current chunk of characters
+static char *chunk_next = NULL;
+static size_t chunk_left = 0;
+
+// Return the FNV-1a hash of the length characters of text
+static uint32_t intern_hash(const char *text, size_t length)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+	h = (h ^ (unsigned char) text[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Allocate a table of n slots (n a power of 2), all empty
+static intern_slot *intern_allocate_slots(size_t n)
+{
+    intern_slot *s = (intern_slot *) calloc(n, sizeof(intern_slot));
+    if (s == NULL) {
+	bail_with_error("No space for the intern table!");
+    }
+    return s;
+}
+
+// initialize the intern table
+void intern_initialize()
+{
+    if (slots != NULL) {
+	return;
+    }
+    num_slots = INTERN_INITIAL_SLOTS;
+    slots = intern_allocate_slots(num_slots);
+    num_names = 0;
+}
+
+// Double the size of the table, moving the names to their new slots
+static void intern_grow()
+{
+    size_t new_num_slots = 2 * num_slots;
+    intern_slot *new_slots = intern_allocate_slots(new_num_slots);
+    for (size_t i = 0; i < num_slots; i++) {
+	if (slots[i].name != NULL) {
+	    size_t j = slots[i].hash & (new_num_slots - 1);
+	    while (new_slots[j].name != NULL) {
+		j = (j + 1) & (new_num_slots - 1);
+	    }
+	    new_slots[j] = slots[i];
+	}
+    }
+    free(slots);
+    slots = new_slots;
+    num_slots = new_num_slots;
+}
+
+// Return a copy of the length characters of text (null-terminated),
+// in the current chunk of characters (or a new one)
+static const char *intern_copy(const char *text, size_t length)
+{
+    size_t size = length + 1;
+    if (size > chunk_left) {
+	size_t chunk_size
+	    = (size > INTERN_CHUNK_SIZE) ? size : INTERN_CHUNK_SIZE;
+	chunk_next = (char *) malloc(chunk_size);
+	if (chunk_next == NULL) {
+	    bail_with_error("No space for interned name!");
+	}
+	chunk_left = chunk_size;
+    }
+    char *copy = chunk_next;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    chunk_next += size;
+    chunk_left -= size;
+    return copy;
+}
+
+// Return the interned copy of the length characters of text,
+// adding it to the table if it is not there yet
+const char *intern_name(const char *text, size_t length)
+{
+    intern_initialize();
+    uint32_t h = intern_hash(text, length);
+    size_t i = h & (num_slots - 1);
+    while (slots[i].name != NULL) {
+	if (slots[i].hash == h && slots[i].length == length
+	    && memcmp(slots[i].name, text, length) == 0) {
+	    return slots[i].name;
+	}
+	i = (i + 1) & (num_slots - 1);
+    }
+    // not found: i is an empty slot
+    const char *name = intern_copy(text, length);
+    slots[i].name = name;
+    slots[i].length = length;
+    slots[i].hash = h;
+    num_names++;
+    if (2 * num_names > num_slots) {
+	intern_grow();
+    }
+    return name;
+}
+
+// Return the number of distinct names interned
+unsigned int intern_count()
+{
+    return num_names;
+}
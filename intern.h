@@ -0,0 +1,24 @@
+#ifndef _INTERN_H
+#define _INTERN_H
+#include <stddef.h>
+
+// The intern table keeps one copy of each distinct name (identifier
+// or reserved word) and number read by the lexer, so that a name is represented
+// by a stable pointer: two names are the same exactly when their
+// pointers are equal, which is how the scope module compares them.
+// Interned names are never freed (nor may they be).
+
+// initialize the intern table (only the first call does anything,
+// so that names interned earlier stay valid)
+extern void intern_initialize();
+
+// Requires: text != NULL and text has length characters
+// (it need not be null-terminated)
+// Return the interned copy of those characters (null-terminated),
+// adding it to the table if it is not there yet
+extern const char *intern_name(const char *text, size_t length);
+
+// Return the number of distinct names interned
+extern unsigned int intern_count();
+
+#endif
@@ -1,473 +1,603 @@
-/* $Id: lexer.c,v 1.3 2023/04/06 18:05:23 leavens Exp leavens $ */
-#include <stdio.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <ctype.h>
-#include <limits.h>
-#include "utilities.h"
-#include "lexer.h"
-#include "reserved.h"
-
-// The input file
-static FILE *input_file = NULL;
-// The input file's name
-static const char *filename = NULL;
-// Is this token stream done (past EOF or error)?
-static bool done = true;
-// the line of the next token
-static unsigned int line;
-// the column of the next token
-static unsigned int column;
-
-// the previous value of column,
-// for use in lexer_ungetchar
-static unsigned int last_column = 0;
-
-// forward declarations of lexical functions
-static void lexer_consume_ignored();
-static token lexer_ident(char c, token t);
-static token lexer_number(char c, token t);
-static token lexer_becomes(char c, token t);
-static token lexer_starts_less(char c, token t);
-static token lexer_starts_greater(char c, token t);
-
-#define MAX_NUM_LENGTH 5
-
-// Check the lexer's invariant
-static void lexer_okay()
-{
-    assert(done == (input_file == NULL));
-    assert(done == (filename == NULL));
-}
-
-// Initialize the lexer (i.e., its data structures)
-static void lexer_initialize()
-{
-    filename = NULL;
-    input_file = NULL;
-    done = true;
-    line = 1;
-    column = 1;
-    reserved_initialize();
-}
-
-// Requires: fname != NULL
-// Requires: fname is the name of a readable file
-// Initialize the lexer and start it reading
-// from the given file name
-void lexer_open(const char *fname)
-{
-    lexer_initialize();
-    
-	input_file = fopen(fname, "r");
-    
-	if (input_file == NULL)
-	{
-		bail_with_error("Cannot open %s", fname);
-    }
-
-    filename = fname;
-    done = feof(input_file);
-
-    if (done)
-	{
-		input_file = NULL;
-		filename = NULL;
-    }
-    
-	lexer_okay();
-}
-
-// Close the file the lexer is working on
-// and make this lexer be done
-void lexer_close()
-{
-    lexer_okay();
-    if (input_file != NULL) {
-	int rc = fclose(input_file);
-	if (rc == EOF) {
-	    bail_with_error("Cannot close %s!", filename);
-	}
-    }
-    input_file = NULL;
-    filename = NULL;
-    done = true;
-    lexer_okay();
-}
-
-// Is the lexer's token stream finished
-// (either past EOF or not open)?
-bool lexer_done()
-{
-    return done;
-}
-
-// Requires: input_file is readable
-// Return the next char in the input
-// updating line and column as appropriate
-// update last_column to the old value of column
-static char lexer_getchar()
-{
-    char c = getc(input_file);
-
-    last_column = column;
-
-    if (c == '\n')
-	{
-		line++;
-		column=1;
-    }
-	else
-	{
-		column++;
-    }
-	
-    return c;
-}
-
-// Requires: input_file is readable
-// Put c back into the input file stream
-// to be read again
-static void lexer_ungetchar(char c)
-{
-    column = last_column;
-
-    if (c == '\n')
-	{
-		line--;
-    }
-
-    if (c != EOF)
-	{
-		ungetc(c, input_file);
-    }
-}
-
-// Requires: !lexer_done()
-// Return the next token in the input file,
-// advancing in the input
-token lexer_next()
-{
-    token t;
-    t.filename = filename;
-    t.typ = eofsym;
-    t.text = NULL;
-    t.value = 0;
-
-    lexer_consume_ignored();
-
-    t.line = line;
-    t.column = column;
-
-    char c = lexer_getchar();
-    
-    // since we consumed all the whitespace
-    // c should not be a kind of space character
-    assert(!isspace(c));
-    
-    if (c == EOF)
-	{
-		t.typ = eofsym;
-		t.text = NULL;
-		filename = NULL;
-		input_file = NULL;
-		done = true;
-		return t;
-    }
-    
-	if (isalpha(c))
-	{
-		return lexer_ident(c, t);
-    }
-	else if (isdigit(c))
-	{
-		return lexer_number(c, t);
-    }
-	else
-	{
-		// leave room in t.text for 2 chars of text
-		t.text = malloc(3 * sizeof(char));
-		if (t.text == NULL)
-		{
-			bail_with_error("Cannot allocate space for token text!");
-		}
-		
-		t.text[0] = c;
-		t.text[1] = '\0';
-		
-		switch (c)
-		{
-			case '.':
-				t.typ = periodsym;
-				break;
-			case ';':
-				t.typ = semisym;
-				break;
-			case ',':
-				t.typ = commasym;
-				break;
-			case ':':
-				return lexer_becomes(c, t);
-			case '=':
-				t.typ = eqsym;
-				break;
-			case '(':
-				t.typ = lparensym;
-				break;
-			case ')':
-				t.typ = rparensym;
-				break;
-			case '<':
-				return lexer_starts_less(c, t);
-				break;
-			case '>':
-				return lexer_starts_greater(c, t);
-				break;
-			case '+':
-				t.typ = plussym;
-				break;
-			case '-':
-				t.typ = minussym;
-				break;
-			case '*':
-				t.typ = multsym;
-				break;
-			case '/':
-				t.typ = divsym;
-				break;
-			default:
-				lexical_error(filename, line, column, "Illegal character '%c' (0%o)", c, c);
-				break;
-		}
-
-		return t;
-    }
-}
-
-// Requires: !lexer_done()
-// Return the name of the current file
-const char *lexer_filename()
-{
-    if (lexer_done())
-	{
-		bail_with_error("Asking for file name of done lexer!");
-    }
-
-    return filename;
-}
-
-// Requires: !lexer_done()
-// Return the line number of the next token
-unsigned int lexer_line()
-{
-    if (lexer_done())
-	{
-		bail_with_error("Asking for line of done lexer!");
-    }
-
-    return line;
-}
-
-// Requires: !lexer_done()
-// Return the column number of the next token
-unsigned int lexer_column()
-{
-    if (lexer_done())
-	{
-		bail_with_error("Asking for column of done lexer!");
-    }
-    
-	return column;
-}
-
-// Requires: input_file is readable
-// Advance input_file to the next newline
-static void lexer_consume_comment()
-{
-    char c = lexer_getchar();
-    
-	while (c != '\n' && c != EOF)
-	{
-		c = lexer_getchar();
-    }
-
-    if (c == EOF)
-	{
-		lexical_error(filename, line, column, "File ended while reading comment!");
-    }
-    // assert(c == '\n');
-}
-
-// Requires: input_file is readable
-// Advance in the input file until
-// the next char is the start of a token
-// that is not ignored
-// (i.e., not whitespace or a comment)
-static void lexer_consume_ignored()
-{
-    char c = lexer_getchar();
-
-    while (isspace(c) || c == '#')
-	{
-		if (isspace(c))
-		{
-			// ignore the whitespace char
-			c = lexer_getchar();
-		}
-		else if (c == '#')
-		{
-			lexer_consume_comment();
-			c = lexer_getchar();
-		}
-    }
-    // assert(!isspace(c) && c != '#');
-    lexer_ungetchar(c);
-}
-
-// Requires: c is a letter
-// Return a token for a reserved word
-// or an identifier
-static token lexer_ident(char c, token t)
-{
-    char *text = malloc((MAX_IDENT_LENGTH+1)*sizeof(char));
-
-    if (text == NULL)
-	{
-		bail_with_error("Cannot allocate space for identifier");
-    }
-
-    text[0] = c;
-    int n = 1;
-    c = lexer_getchar();
-    
-	while (isalpha(c) || isdigit(c))
-	{
-		if (n >= MAX_IDENT_LENGTH)
-		{
-			text[n] = '\0';
-			lexical_error(filename, line, column, "Identifier starting \"%s\" is too long!", text);
-		}
-
-		text[n] = c;
-		n++;
-		c = lexer_getchar();
-    }
-
-    // assert(!isalpha(c) && !isdigit(c));
-    text[n+1] = '\0';    
-    lexer_ungetchar(c);
-    t.text = text;
-    t.typ = reserved_type(text);
-    return t;
-}
-
-// Requires: c is a digit
-// Return a token for a number
-static token lexer_number(char c, token t)
-{
-    char *text = malloc((MAX_NUM_LENGTH+1)*sizeof(char));
-
-    if (text == NULL)
-	{
-		bail_with_error("Cannot allocate space for number");
-    }
-
-    text[0] = c;
-    int n = 1;
-    c = lexer_getchar();
-    
-	while (isdigit(c))
-	{
-		if (n >= MAX_NUM_LENGTH)
-		{
-			text[n] = '\0';
-			bail_with_error(filename, line, column, "Number starting \"%s\" is too long!", text);
-		}
-
-		text[n] = c;
-		n++;
-		c = lexer_getchar();
-	}
-	
-	text[n+1] = '\0';
-	lexer_ungetchar(c);
-	t.text = text;
-	int val;
-	sscanf(text, "%d", &val);
-	
-	if (val > SHRT_MAX)
-	{
-		lexical_error(filename, line, column, "The value of %s is too large for a short!", text);
-	}
-
-    t.value = val;
-    t.typ = numbersym;
-    return t;
-}
-
-// Requires: c is a colon character (:)
-// Returns the token for a becomessym
-static token lexer_becomes(char c, token t)
-{
-    assert(c == ':');
-    c = lexer_getchar();
-
-    if (c != '=')
-	{
-		lexical_error(filename, line, column, "Expecting '=' after a colon, not '%c'", c);
-    }
-
-    t.text[1] = c;
-    t.text[2] = '\0';
-    t.typ = becomessym;
-    return t;
-}
-
-// Requires: c is a less-than character (<)
-// Returns the token appropriate for the next char
-static token lexer_starts_less(char c, token t)
-{
-    assert(c == '<');
-    c = lexer_getchar();
-    t.text[1] = c;
-    t.text[2] = '\0';
-    
-	switch (c)
-	{
-		case '=':
-			t.typ = leqsym;
-			break;
-		case '>':
-			t.typ = neqsym;
-			break;
-		default:
-			t.text[1] = '\0';
-			lexer_ungetchar(c);
-			t.typ = lessym;
-			break;
-    }
-
-    return t;
-}
-
-static token lexer_starts_greater(char c, token t)
-{
-    assert(c == '>');
-    c = lexer_getchar();
-    t.text[1] = c;
-    t.text[2] = '\0';
-    
-	switch (c)
-	{
-		case '=':
-			t.typ = geqsym;
-			break;
-		default:
-			t.text[1] = '\0';
-			lexer_ungetchar(c);
-			t.typ = gtrsym;
-			break;
-    }
-
-    return t;
-}
+/* $Id: lexer.c,v 1.3 2023/04/06 18:05:23 leavens Exp leavens $ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include <ctype.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "utilities.h"
+#include "lexer.h"
+#include "reserved.h"
+#include "intern.h"
+
+// The input file's contents (mapped into memory,
+// or read into a buffer if it cannot be mapped, as for a pipe),
+// which end just before input_end
+static const char *input = NULL;
+static const char *input_end = NULL;
+// the size of the mapping (0 if input was read into a buffer)
+static size_t input_map_size = 0;
+// The input file's name
+static const char *filename = NULL;
+// Is this token stream done (past EOF or error)?
+static bool done = true;
+// the next character to be read
+static const char *cursor;
+// the line of the next character, and the start of that line
+// (and of the line before it, for lexer_ungetchar);
+// columns are only worked out from these when they are needed
+static unsigned int line;
+static const char *line_start;
+static const char *last_line_start;
+// the number of times EOF has been read (and not put back)
+// since the end of the input, each of which counts as a column
+static unsigned int eof_reads;
+// Are lexical errors being kept (see lexer_tokenize) rather than
+// reported at once? If so, the first one's message (or "")
+static bool defer_errors = false;
+static char deferred_error[2048];
+
+// forward declarations of lexical functions
+static void lexer_consume_ignored();
+static token lexer_ident(const char *start, token t);
+static token lexer_number(const char *start, token t);
+static token lexer_becomes(int c, token t);
+static token lexer_starts_less(int c, token t);
+static token lexer_starts_greater(int c, token t);
+
+#define MAX_NUM_LENGTH 5
+
+// Check the lexer's invariant
+static void lexer_okay()
+{
+    assert(done == (filename == NULL));
+    assert(input == NULL || (input <= cursor && cursor <= input_end));
+}
+
+// Give back the space holding the input, if any
+static void lexer_free_input()
+{
+    if (input != NULL) {
+	if (input_map_size > 0) {
+	    munmap((void *) input, input_map_size);
+	} else {
+	    free((void *) input);
+	}
+    }
+    input = NULL;
+    input_end = NULL;
+    input_map_size = 0;
+}
+
+// Initialize the lexer (i.e., its data structures)
+static void lexer_initialize()
+{
+    lexer_free_input();
+    filename = NULL;
+    done = true;
+    cursor = NULL;
+    line = 1;
+    line_start = NULL;
+    last_line_start = NULL;
+    eof_reads = 0;
+    reserved_initialize();
+    intern_initialize();
+}
+
+// Requires: fd is open for reading
+// Read all of the file fd into a new buffer, setting *size to its size
+static char *lexer_read_all(int fd, const char *fname, size_t *size)
+{
+    size_t cap = BUFSIZ;
+    char *buf = (char *) malloc(cap);
+    *size = 0;
+    for (;;) {
+	if (buf == NULL) {
+	    bail_with_error("Cannot allocate space for the input file %s",
+			    fname);
+	}
+	ssize_t n = read(fd, buf + *size, cap - *size);
+	if (n < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (n < 0) {
+	    bail_with_error("Cannot read %s", fname);
+	}
+	if (n == 0) {
+	    return buf;
+	}
+	*size += n;
+	if (*size == cap) {
+	    cap *= 2;
+	    char *bigger = (char *) realloc(buf, cap);
+	    if (bigger == NULL) {
+		free(buf);
+	    }
+	    buf = bigger;
+	}
+    }
+}
+
+// Requires: fname != NULL
+// Requires: fname is the name of a readable file
+// Initialize the lexer and start it reading
+// from the given file name
+void lexer_open(const char *fname)
+{
+    lexer_initialize();
+
+    int fd = open(fname, O_RDONLY);
+
+    if (fd < 0)
+	{
+		bail_with_error("Cannot open %s", fname);
+    }
+
+    // the whole file is scanned where it is, if it can be mapped
+    struct stat st;
+    size_t size = 0;
+    void *mem = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+	size = st.st_size;
+	mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (mem != MAP_FAILED) {
+	input = (const char *) mem;
+	input_map_size = size;
+    } else {
+	input = lexer_read_all(fd, fname, &size);
+    }
+    close(fd);
+    // errors in the program must not show the ones above
+    errno = 0;
+
+    input_end = input + size;
+    cursor = input;
+    line_start = input;
+    last_line_start = input;
+    filename = fname;
+    done = false;
+
+	lexer_okay();
+}
+
+// Close the file the lexer is working on
+// and make this lexer be done
+void lexer_close()
+{
+    lexer_okay();
+    lexer_free_input();
+    filename = NULL;
+    done = true;
+    lexer_okay();
+}
+
+// Is the lexer's token stream finished
+// (either past EOF or not open)?
+bool lexer_done()
+{
+    return done;
+}
+
+// Return the column of the next character
+static unsigned int lexer_current_column()
+{
+    return (cursor - line_start) + 1 + eof_reads;
+}
+
+// Report a lexical error at the current line and column,
+// with the message given by the printf format fmt,
+// at once (so that this does not return), unless errors are
+// being deferred, in which case the first one's message is kept
+static void lexer_error(const char *fmt, ...)
+{
+    char msg[1024];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    if (!defer_errors)
+	{
+		lexical_error(filename, line, lexer_current_column(), "%s", msg);
+    }
+    if (deferred_error[0] == '\0')
+	{
+		// as lexical_error would start it
+		snprintf(deferred_error, sizeof(deferred_error), "%s: line %d, column %d: %s",
+				 filename, line, lexer_current_column(), msg);
+    }
+}
+
+// Requires: input is readable
+// Return the next char in the input, as an unsigned char
+// (or EOF at its end, which is only found by reaching input_end,
+// so that no byte of the input is taken for EOF),
+// updating line and the line's start as appropriate
+static int lexer_getchar()
+{
+    if (cursor == input_end)
+	{
+		eof_reads++;
+		return EOF;
+    }
+
+    int c = (unsigned char) *cursor++;
+
+    if (c == '\n')
+	{
+		line++;
+		last_line_start = line_start;
+		line_start = cursor;
+    }
+
+    return c;
+}
+
+// Requires: input is readable
+// Requires: c is the char last returned by lexer_getchar
+// Put c back into the input
+// to be read again
+static void lexer_ungetchar(int c)
+{
+    // once the end of the input is reached, only EOF is read
+    if (eof_reads > 0)
+	{
+		eof_reads--;
+		return;
+    }
+
+    cursor--;
+
+    if (c == '\n')
+	{
+		line--;
+		line_start = last_line_start;
+    }
+}
+
+// Requires: !lexer_done()
+// Return the next token in the input file,
+// advancing in the input
+token lexer_next()
+{
+    token t;
+    t.filename = filename;
+    t.typ = eofsym;
+    t.text = NULL;
+    t.value = 0;
+
+    lexer_consume_ignored();
+
+    t.line = line;
+    t.column = lexer_current_column();
+
+    const char *start = cursor;
+    int c = lexer_getchar();
+    
+    // since we consumed all the whitespace
+    // c should not be a kind of space character
+    assert(!isspace(c));
+    
+    if (c == EOF)
+	{
+		t.typ = eofsym;
+		t.text = NULL;
+		filename = NULL;
+		done = true;
+		return t;
+    }
+    
+	if (isalpha(c))
+	{
+		return lexer_ident(start, t);
+    }
+	else if (isdigit(c))
+	{
+		return lexer_number(start, t);
+    }
+	else
+	{
+		switch (c)
+		{
+			case '.':
+				t.typ = periodsym;
+				break;
+			case ';':
+				t.typ = semisym;
+				break;
+			case ',':
+				t.typ = commasym;
+				break;
+			case ':':
+				return lexer_becomes(c, t);
+			case '=':
+				t.typ = eqsym;
+				break;
+			case '(':
+				t.typ = lparensym;
+				break;
+			case ')':
+				t.typ = rparensym;
+				break;
+			case '<':
+				return lexer_starts_less(c, t);
+				break;
+			case '>':
+				return lexer_starts_greater(c, t);
+				break;
+			case '+':
+				t.typ = plussym;
+				break;
+			case '-':
+				t.typ = minussym;
+				break;
+			case '*':
+				t.typ = multsym;
+				break;
+			case '/':
+				t.typ = divsym;
+				break;
+			default:
+				lexer_error("Illegal character '%c' (0%o)", c, c);
+				break;
+		}
+
+		// the text of punctuation and operators is not allocated
+		t.text = ttyp2spelling(t.typ);
+		return t;
+    }
+}
+
+// Requires: fname != NULL
+// Requires: fname is the name of a readable file
+// Read all the tokens of the file named fname into ta,
+// ending with its eofsym token, or stopping at a lexical error,
+// which is kept in ta (to be reported when its reader reaches it)
+void lexer_tokenize(const char *fname, token_array *ta)
+{
+    lexer_open(fname);
+    token_array_initialize(ta, fname);
+    defer_errors = true;
+    deferred_error[0] = '\0';
+    while (!lexer_done())
+	{
+		token t = lexer_next();
+		if (deferred_error[0] != '\0')
+		{
+			token_array_set_error(ta, deferred_error);
+			break;
+		}
+		token_array_add(ta, t);
+    }
+    defer_errors = false;
+    // the tokens' text is not in the input, which is no longer needed
+    lexer_close();
+}
+
+// Requires: !lexer_done()
+// Return the name of the current file
+const char *lexer_filename()
+{
+    if (lexer_done())
+	{
+		bail_with_error("Asking for file name of done lexer!");
+    }
+
+    return filename;
+}
+
+// Requires: !lexer_done()
+// Return the line number of the next token
+unsigned int lexer_line()
+{
+    if (lexer_done())
+	{
+		bail_with_error("Asking for line of done lexer!");
+    }
+
+    return line;
+}
+
+// Requires: !lexer_done()
+// Return the column number of the next token
+unsigned int lexer_column()
+{
+    if (lexer_done())
+	{
+		bail_with_error("Asking for column of done lexer!");
+    }
+    
+	return lexer_current_column();
+}
+
+// Requires: input is readable
+// Advance the input past the next newline
+static void lexer_consume_comment()
+{
+    const char *newline = memchr(cursor, '\n', input_end - cursor);
+
+    if (newline == NULL)
+	{
+		// the comment's characters, and the EOF read after them
+		cursor = input_end;
+		eof_reads++;
+		lexer_error("File ended while reading comment!");
+		return;
+    }
+
+    cursor = newline + 1;
+    line++;
+    last_line_start = line_start;
+    line_start = cursor;
+}
+
+// Requires: input is readable
+// Advance in the input until
+// the next char is the start of a token
+// that is not ignored
+// (i.e., not whitespace or a comment)
+static void lexer_consume_ignored()
+{
+    while (cursor < input_end)
+	{
+		char c = *cursor;
+
+		if (c == '\n')
+		{
+			cursor++;
+			line++;
+			last_line_start = line_start;
+			line_start = cursor;
+		}
+		else if (isspace((unsigned char) c))
+		{
+			// ignore the whitespace char
+			cursor++;
+		}
+		else if (c == '#')
+		{
+			cursor++;
+			lexer_consume_comment();
+		}
+		else
+		{
+			break;
+		}
+    }
+    // assert(cursor == input_end || (!isspace(*cursor) && *cursor != '#'));
+}
+
+// Requires: start is where a letter was read (just before cursor)
+// Return a token for a reserved word
+// or an identifier
+static token lexer_ident(const char *start, token t)
+{
+    while (cursor < input_end && isalnum((unsigned char) *cursor))
+	{
+		cursor++;
+    }
+
+    // the text is only as long as the identifier (allowed to be),
+    // and is interned, so each name is stored once
+    size_t n = cursor - start;
+    size_t len = (n > MAX_IDENT_LENGTH) ? MAX_IDENT_LENGTH : n;
+    const char *text = intern_name(start, len);
+
+    if (n > MAX_IDENT_LENGTH)
+	{
+		// reported once the character after the longest identifier
+		// allowed has been read
+		cursor = start + MAX_IDENT_LENGTH + 1;
+		lexer_error("Identifier starting \"%s\" is too long!", text);
+    }
+
+    // assert(!isalpha(*cursor) && !isdigit(*cursor));
+    t.text = text;
+    t.typ = reserved_lookup(text, len);
+    return t;
+}
+
+// Requires: start is where a digit was read (just before cursor)
+// Return a token for a number
+static token lexer_number(const char *start, token t)
+{
+    while (cursor < input_end && isdigit((unsigned char) *cursor))
+	{
+		cursor++;
+    }
+
+    // the text is interned, as numbers repeat as names do
+    size_t n = cursor - start;
+    size_t len = (n > MAX_NUM_LENGTH) ? MAX_NUM_LENGTH : n;
+    const char *text = intern_name(start, len);
+
+    if (n > MAX_NUM_LENGTH)
+	{
+		cursor = start + MAX_NUM_LENGTH + 1;
+		lexer_error("Number starting \"%s\" is too long!", text);
+    }
+
+	t.text = text;
+	int val = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		val = 10 * val + (text[i] - '0');
+	}
+	
+	if (val > SHRT_MAX)
+	{
+		lexer_error("The value of %s is too large for a short!", text);
+	}
+
+    t.value = val;
+    t.typ = numbersym;
+    return t;
+}
+
+// Requires: c is a colon character (:)
+// Returns the token for a becomessym
+static token lexer_becomes(int c, token t)
+{
+    assert(c == ':');
+    c = lexer_getchar();
+
+    if (c != '=')
+	{
+		lexer_error("Expecting '=' after a colon, not '%c'", c);
+    }
+
+    t.typ = becomessym;
+    t.text = ttyp2spelling(t.typ);
+    return t;
+}
+
+// Requires: c is a less-than character (<)
+// Returns the token appropriate for the next char
+static token lexer_starts_less(int c, token t)
+{
+    assert(c == '<');
+    c = lexer_getchar();
+    
+	switch (c)
+	{
+		case '=':
+			t.typ = leqsym;
+			break;
+		case '>':
+			t.typ = neqsym;
+			break;
+		default:
+			lexer_ungetchar(c);
+			t.typ = lessym;
+			break;
+    }
+
+    t.text = ttyp2spelling(t.typ);
+    return t;
+}
+
+static token lexer_starts_greater(int c, token t)
+{
+    assert(c == '>');
+    c = lexer_getchar();
+    
+	switch (c)
+	{
+		case '=':
+			t.typ = geqsym;
+			break;
+		default:
+			lexer_ungetchar(c);
+			t.typ = gtrsym;
+			break;
+    }
+
+    t.text = ttyp2spelling(t.typ);
+    return t;
+}
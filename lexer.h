@@ -1,37 +1,51 @@
-/* $Id: lexer.h,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
-#ifndef _LEXER_H
-#define _LEXER_H
-#include <stdbool.h>
-#include "token.h"
-
-// Requires: fname != NULL
-// Requires: fname is the name of a readable file
-// Initialize the lexer and start it reading
-// from the given file name
-extern void lexer_open(const char *fname);
-
-// Close the file the lexer is working on
-// and make this lexer be done
-extern void lexer_close();
-
-// Is the lexer's token stream finished
-// (either at EOF or not open)?
-extern bool lexer_done();
-
-// Requires: !lexer_done()
-// Return the next token in the input file,
-// advancing in the input
-extern token lexer_next();
-
-// Requires: !lexer_done()
-// Return the name of the current file
-extern const char *lexer_filename();
-
-// Requires: !lexer_done()
-// Return the line number of the next token
-extern unsigned int lexer_line();
-
-// Requires: !lexer_done()
-// Return the column number of the next token
-extern unsigned int lexer_column();
-#endif
+/* $Id: lexer.h,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
+#ifndef _LEXER_H
+#define _LEXER_H
+#include <stdbool.h>
+#include "token.h"
+#include "token_array.h"
+
+// Requires: fname != NULL
+// Requires: fname is the name of a readable file
+// Initialize the lexer and start it reading
+// from the given file name
+extern void lexer_open(const char *fname);
+
+// Close the file the lexer is working on
+// and make this lexer be done
+extern void lexer_close();
+
+// Is the lexer's token stream finished
+// (either at EOF or not open)?
+extern bool lexer_done();
+
+// Requires: !lexer_done()
+// Return the next token in the input file,
+// advancing in the input;
+// no space is allocated for the token's text: that of an identifier,
+// reserved word, or number is interned (see intern.h), and that of
+// other tokens is their fixed spelling (see ttyp2spelling),
+// so it must not be changed or freed
+extern token lexer_next();
+
+// Requires: fname != NULL
+// Requires: fname is the name of a readable file
+// Read all the tokens of the file named fname into ta
+// (see token_array.h), ending with its eofsym token,
+// or stopping at a lexical error, which is reported when ta's reader
+// asks for the token after those read before it;
+// the lexer is done afterwards
+extern void lexer_tokenize(const char *fname, token_array *ta);
+
+// Requires: !lexer_done()
+// Return the name of the current file
+extern const char *lexer_filename();
+
+// Requires: !lexer_done()
+// Return the line number of the next token
+extern unsigned int lexer_line();
+
+// Requires: !lexer_done()
+// Return the column number of the next token
+extern unsigned int lexer_column();
+#endif
@@ -1,40 +1,69 @@
-/* $Id: lexer_output.c,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
-#include <stdio.h>
-#include <stdlib.h>
-#include "lexer.h"
-
-// Requires: lexer is not done
-// Print a message about the file name of the lexer's input
-// And print a heading for the lexer's output.
-// Both are printed on stdout.
-static void lexer_print_output_header()
-{
-    printf("Tokens from file %s\n", lexer_filename());
-    printf("Number Name       Line Column Text/Value\n");
-}
-
-// Print information about the token t to stdout
-// followed by a newline
-static void lexer_print_token(token t)
-{
-    printf("%-6d %-10s %-4d %-6d", t.typ, ttyp2str(t.typ),
-	   t.line, t.column);
-    if (t.typ == numbersym) {
-	printf(" %d\n", t.value);
-    } else {
-	if (t.text != NULL) {
-	    printf(" \"%s\"\n", t.text);
-	} else {
-	    printf("\n");
-	}
-    }
-}
-
-void lexer_output()
-{
-    lexer_print_output_header();
-    while (!lexer_done()) {
-	token t = lexer_next();
-	lexer_print_token(t);
-    }
-}
+/* $Id: lexer_output.c,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <time.h>
+#include "lexer.h"
+
+// Print a message about the file name of the tokens in ta
+// And print a heading for the lexer's output.
+// Both are printed on stdout.
+static void lexer_print_output_header(token_array *ta)
+{
+    printf("Tokens from file %s\n", ta->filename);
+    printf("Number Name       Line Column Text/Value\n");
+}
+
+// Print information about the token t to stdout
+// followed by a newline
+static void lexer_print_token(token t)
+{
+    printf("%-6d %-10s %-4d %-6d", t.typ, ttyp2str(t.typ),
+	   t.line, t.column);
+    if (t.typ == numbersym) {
+	printf(" %d\n", t.value);
+    } else {
+	if (t.text != NULL) {
+	    printf(" \"%s\"\n", t.text);
+	} else {
+	    printf("\n");
+	}
+    }
+}
+
+void lexer_output(token_array *ta)
+{
+    lexer_print_output_header(ta);
+    // the last token is an eofsym, unless the lexer found an error,
+    // which is reported when the token after the others is asked for
+    token t;
+    unsigned int i = 0;
+    do {
+	t = token_array_get(ta, i++);
+	lexer_print_token(t);
+    } while (t.typ != eofsym);
+}
+
+void lexer_benchmark()
+{
+    const char *fname = lexer_filename();
+    unsigned long tokens = 0, identifiers = 0, reserved = 0;
+    clock_t start = clock();
+    while (!lexer_done()) {
+	token t = lexer_next();
+	tokens++;
+	if (t.typ == identsym) {
+	    identifiers++;
+	} else if (t.text != NULL && isalpha((unsigned char) t.text[0])) {
+	    reserved++;
+	}
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    fprintf(stderr, "Lexed %s: %lu tokens (%lu identifiers,"
+	    " %lu reserved words) in %.3f ms",
+	    fname, tokens, identifiers, reserved, seconds * 1000.0);
+    if (tokens > 0) {
+	fprintf(stderr, ", %.1f ns per token", seconds * 1e9 / tokens);
+    }
+    fprintf(stderr, "\n");
+}
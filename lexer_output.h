@@ -1,10 +1,16 @@
-/* $Id: lexer_output.h,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
-#ifndef _LEXER_OUTPUT_H
-#define _LEXER_OUTPUT_H
-#include "lexer.h"
-
-// Requires: the lexer is not done
-// Output to stdout a table
-// of all the tokens read from the lexer's input file
-extern void lexer_output();
-#endif
+/* $Id: lexer_output.h,v 1.1 2023/03/08 15:18:43 leavens Exp $ */
+#ifndef _LEXER_OUTPUT_H
+#define _LEXER_OUTPUT_H
+#include "lexer.h"
+
+// Requires: ta holds the tokens of a file (see lexer_tokenize)
+// Output to stdout a table
+// of all the tokens in ta
+extern void lexer_output(token_array *ta);
+
+// Requires: the lexer is not done
+// Read all the tokens from the lexer's input file, without printing
+// them, and print on stderr how many there were (and how many of them
+// were identifiers and reserved words) and the CPU time that took
+extern void lexer_benchmark();
+#endif
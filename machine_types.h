@@ -1,14 +1,22 @@
-/* $Id: machine_types.h,v 1.1 2023/03/20 21:23:14 leavens Exp $ */
-#ifndef _MACHINE_TYPES_H
-#define _MACHINE_TYPES_H
-
-// words for this machine
-typedef short int word;
-
-// addresses for this machine
-typedef unsigned short int address;
-
-// number of words used by call instruction
-#define LINKS_SIZE 3
-
-#endif
+/* $Id: machine_types.h,v 1.1 2023/03/20 21:23:14 leavens Exp $ */
+#ifndef _MACHINE_TYPES_H
+#define _MACHINE_TYPES_H
+
+// words for this machine
+typedef short int word;
+
+// addresses for this machine
+typedef unsigned short int address;
+
+// number of words used by call instruction
+#define LINKS_SIZE 3
+
+// number of words used by a call instruction that pushes
+// no static link (CNL)
+#define LINKS_SIZE_NO_STAT_LNK 2
+
+// number of entries in the VM's display (for the PDB, SDB, and RDB
+// instructions), more than the deepest nesting of procedures
+#define DISPLAY_SIZE 128
+
+#endif
@@ -1,37 +1,103 @@
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-#include "reserved.h"
-
-static const char *reserved_words[NUM_RESERVED_WORDS]
-        = {"const", "var", "procedure",
-           "call", "begin", "end",
-	   "if", "then", "else", "while", "do",
-           "read", "write", "skip", "odd"};
-
-static token_type reserved_types[NUM_RESERVED_WORDS]
-         = {constsym, varsym, procsym,
-           callsym, beginsym, endsym,
-	   ifsym, thensym, elsesym, whilesym, dosym,
-	   readsym, writesym, skipsym, oddsym};
-
-// initialize the data structures of the
-// reserved module
-void reserved_initialize()
-{
-    // nothing to do!
-}
-
-// Requires: text != NULL
-// If text is a reserved word,
-// then return its token_type,
-// else return the token_type identsym
-token_type reserved_type(const char *text)
-{
-    for (int i = 0; i < NUM_RESERVED_WORDS; i++) {
-	if (strcmp(text, reserved_words[i]) == 0) {
-	    return reserved_types[i];
-	}
-    }
-    return identsym;
-}
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "utilities.h"
+#include "reserved.h"
+
+// The reserved words are found with a perfect hash: a word's slot
+// in reserved_table depends only on its length and its first two
+// characters, and no two reserved words have the same slot, so a word
+// is looked up with at most one comparison. (The first and last
+// characters would not do, as "while" and "write" share them.)
+// The table is laid out by the C compiler, which computes each word's
+// slot from the character constants in its initializer;
+// reserved_initialize checks that no two words were given one slot.
+
+// the number of slots in reserved_table (a power of 2)
+#define RESERVED_TABLE_SIZE 32
+
+// the slot of a word of length len whose first two characters
+// are c0 and c1
+#define RESERVED_HASH(len, c0, c1) \
+    ((unsigned) ((unsigned char) (c0) + 9 * (unsigned char) (c1) + (len)) \
+     & (RESERVED_TABLE_SIZE - 1))
+
+// a slot of reserved_table (empty if word is NULL)
+typedef struct {
+    const char *word;
+    size_t length;
+    token_type typ;
+} reserved_entry;
+
+// a slot's initializer, for the reserved word w (a string literal)
+// whose first two characters are c0 and c1
+#define RESERVED(w, c0, c1, ty) \
+    [RESERVED_HASH(sizeof(w) - 1, c0, c1)] = {w, sizeof(w) - 1, ty}
+
+static const reserved_entry reserved_table[RESERVED_TABLE_SIZE] = {
+    RESERVED("const", 'c', 'o', constsym),
+    RESERVED("var", 'v', 'a', varsym),
+    RESERVED("procedure", 'p', 'r', procsym),
+    RESERVED("call", 'c', 'a', callsym),
+    RESERVED("begin", 'b', 'e', beginsym),
+    RESERVED("end", 'e', 'n', endsym),
+    RESERVED("if", 'i', 'f', ifsym),
+    RESERVED("then", 't', 'h', thensym),
+    RESERVED("else", 'e', 'l', elsesym),
+    RESERVED("while", 'w', 'h', whilesym),
+    RESERVED("do", 'd', 'o', dosym),
+    RESERVED("read", 'r', 'e', readsym),
+    RESERVED("write", 'w', 'r', writesym),
+    RESERVED("skip", 's', 'k', skipsym),
+    RESERVED("odd", 'o', 'd', oddsym)
+};
+
+// initialize the data structures of the
+// reserved module
+void reserved_initialize()
+{
+    // a word given the slot of another would replace it in the table
+    // (and a wrong character given for a word would put it in the wrong
+    // slot), so check that every reserved word is found
+    int found = 0;
+    for (int i = 0; i < RESERVED_TABLE_SIZE; i++) {
+	const reserved_entry *e = &reserved_table[i];
+	if (e->word != NULL) {
+	    if (reserved_lookup(e->word, e->length) != e->typ) {
+		bail_with_error("Reserved word \"%s\" is not in its slot",
+				e->word);
+	    }
+	    found++;
+	}
+    }
+    if (found != NUM_RESERVED_WORDS) {
+	bail_with_error("Only %d of the %d reserved words are in the table",
+			found, NUM_RESERVED_WORDS);
+    }
+}
+
+// Requires: text != NULL
+// If text is a reserved word,
+// then return its token_type,
+// else return the token_type identsym
+token_type reserved_type(const char *text)
+{
+    return reserved_lookup(text, strlen(text));
+}
+
+// Requires: text != NULL and text has length characters
+// If those characters are a reserved word,
+// then return its token_type,
+// else return the token_type identsym
+token_type reserved_lookup(const char *text, size_t length)
+{
+    if (length < MIN_RESERVED_LENGTH || length > MAX_RESERVED_LENGTH) {
+	return identsym;
+    }
+    const reserved_entry *e
+	= &reserved_table[RESERVED_HASH(length, text[0], text[1])];
+    if (e->length == length && memcmp(text, e->word, length) == 0) {
+	return e->typ;
+    }
+    return identsym;
+}
@@ -1,17 +1,29 @@
-#ifndef _RESERVED_H
-#define _RESERVED_H
-#include "token.h"
-
-#define NUM_RESERVED_WORDS 15
-
-// initialize the data structures of the
-// reserved module
-extern void reserved_initialize();
-
-// Requires: text != NULL
-// If text is a reserved word,
-// then return its token_type,
-// else return the token_type nosym
-extern token_type reserved_type(const char *text);
-
-#endif
+#ifndef _RESERVED_H
+#define _RESERVED_H
+#include <stddef.h>
+#include "token.h"
+
+#define NUM_RESERVED_WORDS 15
+
+// the lengths of the shortest and longest reserved words
+#define MIN_RESERVED_LENGTH 2
+#define MAX_RESERVED_LENGTH 9
+
+// initialize the data structures of the
+// reserved module
+extern void reserved_initialize();
+
+// Requires: text != NULL
+// If text is a reserved word,
+// then return its token_type,
+// else return the token_type identsym
+extern token_type reserved_type(const char *text);
+
+// Requires: text != NULL and text has length characters
+// (it need not be null-terminated)
+// If those characters are a reserved word,
+// then return its token_type,
+// else return the token_type identsym
+extern token_type reserved_lookup(const char *text, size_t length);
+
+#endif
@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include "utilities.h"
+#include "ast.h"
+#include "static_links.h"
+
+// the procedure declarations in the program, in the order found
+static AST **procs = NULL;
+static int num_procs = 0;
+static int procs_capacity = 0;
+
+// Add pd to procs
+static void add_proc(AST *pd)
+{
+    if (num_procs == procs_capacity) {
+	procs_capacity = (procs_capacity == 0) ? 16 : 2 * procs_capacity;
+	procs = (AST **) realloc(procs, sizeof(AST *) * procs_capacity);
+	if (procs == NULL) {
+	    bail_with_error("Not enough space to analyze static links!");
+	}
+    }
+    procs[num_procs++] = pd;
+}
+
+// Add the procedures declared in blk (and in them) to procs
+static void collect_procs(AST *blk)
+{
+    AST_list pds = blk->data.program.pds;
+    while (!ast_list_is_empty(pds)) {
+	AST *pd = ast_list_first(pds);
+	add_proc(pd);
+	collect_procs(pd->data.proc_decl.block);
+	pds = ast_list_rest(pds);
+    }
+}
+
+// Is ident (an identifier AST) declared in an enclosing scope?
+static bool is_outer(AST *ident)
+{
+    return ident->data.ident.idu->levelsOutward > 0;
+}
+
+// Does the expression (or condition) exp use an identifier
+// declared in an enclosing scope?
+static bool expr_uses_outer(AST *exp)
+{
+    switch (exp->type_tag) {
+    case ident_ast:
+	return is_outer(exp);
+    case bin_expr_ast:
+	return expr_uses_outer(exp->data.bin_expr.leftexp)
+	    || expr_uses_outer(exp->data.bin_expr.rightexp);
+    case odd_cond_ast:
+	return expr_uses_outer(exp->data.odd_cond.exp);
+    case bin_cond_ast:
+	return expr_uses_outer(exp->data.bin_cond.leftexp)
+	    || expr_uses_outer(exp->data.bin_cond.rightexp);
+    default:
+	return false;
+    }
+}
+
+// Does stmt use a constant or variable declared in an enclosing scope
+// (if calls is false), or call a procedure that needs a static link
+// (if calls is true)?
+static bool stmt_needs_link(AST *stmt, bool calls)
+{
+    switch (stmt->type_tag) {
+    case assign_ast:
+	return !calls && (is_outer(stmt->data.assign_stmt.ident)
+			  || expr_uses_outer(stmt->data.assign_stmt.exp));
+    case call_ast:
+	return calls && stmt->data.call_stmt.ident->data.ident.idu->attrs
+	    ->decl->data.proc_decl.static_link;
+    case begin_ast:
+	{
+	    AST_list stmts = stmt->data.begin_stmt.stmts;
+	    while (!ast_list_is_empty(stmts)) {
+		if (stmt_needs_link(ast_list_first(stmts), calls)) {
+		    return true;
+		}
+		stmts = ast_list_rest(stmts);
+	    }
+	    return false;
+	}
+    case if_ast:
+	return (!calls && expr_uses_outer(stmt->data.if_stmt.cond))
+	    || stmt_needs_link(stmt->data.if_stmt.thenstmt, calls)
+	    || stmt_needs_link(stmt->data.if_stmt.elsestmt, calls);
+    case while_ast:
+	return (!calls && expr_uses_outer(stmt->data.while_stmt.cond))
+	    || stmt_needs_link(stmt->data.while_stmt.stmt, calls);
+    case read_ast:
+	return !calls && is_outer(stmt->data.read_stmt.ident);
+    case write_ast:
+	return !calls && expr_uses_outer(stmt->data.write_stmt.exp);
+    default:
+	return false;
+    }
+}
+
+// Decide which procedures declared in prog need a static link
+void static_links_analyze(AST *prog, bool use_display)
+{
+    num_procs = 0;
+    collect_procs(prog);
+    for (int i = 0; i < num_procs; i++) {
+	AST *blk = procs[i]->data.proc_decl.block;
+	procs[i]->data.proc_decl.static_link = use_display
+	    ? !ast_list_is_empty(blk->data.program.pds)
+	    : stmt_needs_link(blk->data.program.stmt, false);
+    }
+    if (use_display) {
+	return;
+    }
+    // a procedure that calls one that needs a static link needs one too,
+    // which may make its callers need one, and so on
+    bool changed = true;
+    while (changed) {
+	changed = false;
+	for (int i = 0; i < num_procs; i++) {
+	    proc_decl_t *pd = &procs[i]->data.proc_decl;
+	    if (!pd->static_link
+		&& stmt_needs_link(pd->block->data.program.stmt, true)) {
+		pd->static_link = true;
+		changed = true;
+	    }
+	}
+    }
+}
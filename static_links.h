@@ -0,0 +1,24 @@
+#ifndef _STATIC_LINKS_H
+#define _STATIC_LINKS_H
+#include <stdbool.h>
+#include "ast.h"
+
+// A procedure's frames need a static link only if following it
+// can reach them: without the display (see gen_code_set_display),
+// a procedure needs one if its statement uses a constant or variable
+// of an enclosing scope (so it follows its static link), or calls
+// a procedure that needs one (as CAL copies the caller's static link
+// into the callee's frame); with the display, static links are
+// never followed, and the word at BP is only used to save
+// a display entry, so only procedures that have procedures declared
+// in them (and so keep their level's display entry) need one.
+// The others are called with CNL and return with RNL,
+// which push and pop only the dynamic link and return address.
+
+// Requires: prog has been scope checked (so each identifier's
+//           id_use is set)
+// Decide which procedures declared in prog need a static link,
+// setting the static_link field of each one's declaration,
+// with the rules for code that uses the display if use_display is true
+extern void static_links_analyze(AST *prog, bool use_display);
+#endif
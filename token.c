@@ -1,20 +1,41 @@
-#include "token.h"
-
-// Translation from enum values to strings
-static const char *ttstrs[34] =
-    {"periodsym", "constsym", "semisym", "commasym",
-    "varsym", "procsym", "becomessym", "callsym", "beginsym", "endsym",
-    "ifsym", "thensym", "elsesym", "whilesym", "dosym",
-    "readsym", "writesym", "skipsym",
-    "oddsym", "lparensym", "rparensym",
-    "identsym", "numbersym",
-    "eqsym", "neqsym", "lessym", "leqsym", "gtrsym", "geqsym",
-    "plussym", "minussym", "multsym", "divsym",
-    "eofsym"};
-
-// Return the name of the token_type enum
-// corresponding to the given token_type value
-const char *ttyp2str(token_type ttyp)
-{
-    return ttstrs[ttyp];
-}
+#include <stddef.h>
+#include "token.h"
+
+// Translation from enum values to strings
+static const char *ttstrs[34] =
+    {"periodsym", "constsym", "semisym", "commasym",
+    "varsym", "procsym", "becomessym", "callsym", "beginsym", "endsym",
+    "ifsym", "thensym", "elsesym", "whilesym", "dosym",
+    "readsym", "writesym", "skipsym",
+    "oddsym", "lparensym", "rparensym",
+    "identsym", "numbersym",
+    "eqsym", "neqsym", "lessym", "leqsym", "gtrsym", "geqsym",
+    "plussym", "minussym", "multsym", "divsym",
+    "eofsym"};
+
+// Return the name of the token_type enum
+// corresponding to the given token_type value
+const char *ttyp2str(token_type ttyp)
+{
+    return ttstrs[ttyp];
+}
+
+// The text of the tokens of each type with a fixed spelling,
+// so that the lexer need not allocate space for it
+static const char *ttspellings[34] =
+    {".", "const", ";", ",",
+    "var", "procedure", ":=", "call", "begin", "end",
+    "if", "then", "else", "while", "do",
+    "read", "write", "skip",
+    "odd", "(", ")",
+    NULL, NULL,
+    "=", "<>", "<", "<=", ">", ">=",
+    "+", "-", "*", "/",
+    NULL};
+
+// Return the text of every token of the given token_type,
+// or NULL if their text varies or they have none
+const char *ttyp2spelling(token_type ttyp)
+{
+    return ttspellings[ttyp];
+}
@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+#include "token_array.h"
+
+// the initial capacity of a token array
+#define TOKEN_ARRAY_INITIAL_CAPACITY 1024
+
+// Make ta an empty token array for the tokens of the file
+// named filename
+void token_array_initialize(token_array *ta, const char *filename)
+{
+    ta->filename = filename;
+    ta->entries = NULL;
+    ta->size = 0;
+    ta->capacity = 0;
+    ta->error = NULL;
+}
+
+// Add the token t to the end of ta
+void token_array_add(token_array *ta, token t)
+{
+    if (ta->size == ta->capacity) {
+	unsigned int new_capacity = (ta->capacity == 0)
+	    ? TOKEN_ARRAY_INITIAL_CAPACITY : 2 * ta->capacity;
+	token_entry *new_entries = (token_entry *)
+	    realloc(ta->entries, new_capacity * sizeof(token_entry));
+	if (new_entries == NULL) {
+	    bail_with_error("No space for the tokens of %s!", ta->filename);
+	}
+	ta->entries = new_entries;
+	ta->capacity = new_capacity;
+    }
+    token_entry *e = &ta->entries[ta->size++];
+    e->text = t.text;
+    e->line = t.line;
+    e->column = t.column;
+    e->value = t.value;
+    e->typ = (unsigned char) t.typ;
+}
+
+// Record that the lexer found the error with the given message
+// after ta's tokens
+void token_array_set_error(token_array *ta, const char *message)
+{
+    ta->error = (char *) malloc(strlen(message) + 1);
+    if (ta->error == NULL) {
+	bail_with_error("No space for the error message of %s!",
+			ta->filename);
+    }
+    strcpy(ta->error, message);
+}
+
+// Return the token at index i of ta; if i == ta->size,
+// report the lexer's error and exit
+token token_array_get(token_array *ta, unsigned int i)
+{
+    if (i >= ta->size) {
+	if (ta->error != NULL) {
+	    bail_with_error("%s", ta->error);
+	}
+	bail_with_error("Asking for token %u of %s, which has only %u!",
+			i, ta->filename, ta->size);
+    }
+    const token_entry *e = &ta->entries[i];
+    token t;
+    t.typ = (token_type) e->typ;
+    t.filename = ta->filename;
+    t.line = e->line;
+    t.column = e->column;
+    t.text = e->text;
+    t.value = e->value;
+    return t;
+}
+
+// Give back the space used by ta
+void token_array_free(token_array *ta)
+{
+    free(ta->entries);
+    free(ta->error);
+    token_array_initialize(ta, ta->filename);
+}
@@ -0,0 +1,56 @@
+#ifndef _TOKEN_ARRAY_H
+#define _TOKEN_ARRAY_H
+#include <stdbool.h>
+#include "token.h"
+
+// A token array holds all the tokens of a file, read at once
+// (see lexer_tokenize), in one contiguous block, so that the parser
+// and the lexer's listing (-l) walk them by index, and any token
+// can be looked at again or ahead of time.
+// If the lexer found an error, the array holds the tokens before it,
+// and the error is reported when the token after them is asked for,
+// just when reading tokens one by one would have reported it.
+
+// a token in a token array (its file name is the array's)
+typedef struct {
+    const char *text; // the token's text (see lexer_next), or NULL
+    unsigned int line;
+    unsigned int column;
+    short int value; // when typ==numbersym, its value
+    unsigned char typ; // the token's token_type
+} token_entry;
+
+typedef struct {
+    // the name of the file the tokens were read from
+    const char *filename;
+    // the tokens, of which there are size (with room for capacity)
+    token_entry *entries;
+    unsigned int size;
+    unsigned int capacity;
+    // the message of the lexical error found after the tokens,
+    // or NULL if there was none (then the last token is an eofsym)
+    char *error;
+} token_array;
+
+// Make ta an empty token array for the tokens of the file
+// named filename
+extern void token_array_initialize(token_array *ta, const char *filename);
+
+// Add the token t to the end of ta
+extern void token_array_add(token_array *ta, token t);
+
+// Requires: ta->error == NULL
+// Record that the lexer found the error with the given message
+// (which starts with the file name and position) after ta's tokens
+extern void token_array_set_error(token_array *ta, const char *message);
+
+// Requires: i <= ta->size, and i < ta->size unless ta->error != NULL
+// Return the token at index i of ta; if i == ta->size,
+// report the lexer's error on stderr and exit with a failure code,
+// so that this does not return
+extern token token_array_get(token_array *ta, unsigned int i);
+
+// Give back the space used by ta (its tokens' text is not freed)
+extern void token_array_free(token_array *ta);
+
+#endif
@@ -0,0 +1,495 @@
+// for strdup
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "utilities.h"
+#include "vm_api.h"
+#include "batch.h"
+
+// a program to run, and what happened when it ran
+typedef struct {
+    char *program; // the name of the program's file
+    char *input;   // the name of the file it reads from (or NULL)
+    bool halted;   // did it halt (rather than fail)?
+    unsigned long instructions; // the instructions it executed
+    double millis;  // its wall time, in milliseconds
+    char *message;  // its error message (or NULL)
+} batch_job;
+
+// a thread that runs jobs, with its queue of jobs still to run
+typedef struct {
+    pthread_t thread;
+    // the queue holds the indexes of jobs queue[head] to queue[tail-1];
+    // its owner takes jobs from the tail, and other threads steal them
+    // from the head, always holding lock
+    pthread_mutex_t lock;
+    int *queue;
+    int head;
+    int tail;
+    // the VM used for each job this thread runs
+    vm_t *vm;
+    // the current job's input (in_len bytes, read up to in_next)
+    char *in;
+    size_t in_len;
+    size_t in_next;
+    // the current job's output (out_len bytes, with room for out_cap)
+    char *out;
+    size_t out_len;
+    size_t out_cap;
+} batch_worker;
+
+// the jobs, in the order they were given
+static batch_job *jobs;
+static int num_jobs;
+
+// the threads running them
+static batch_worker *workers;
+static int num_workers;
+
+// the options given to batch_run
+static const char *output_dir;
+static int max_stack_height;
+static unsigned long max_fuel;
+static engine_kind run_engine;
+static bool counting;
+
+// Return a new array of n elements of the given size, bailing if
+// there is not enough space
+static void *allocate(size_t n, size_t size)
+{
+    void *ret = calloc(n, size);
+    if (ret == NULL) {
+	bail_with_error("Not enough space for the batch's jobs!");
+    }
+    return ret;
+}
+
+// Return a copy of s, bailing if there is not enough space
+static char *copy_string(const char *s)
+{
+    char *ret = strdup(s);
+    if (ret == NULL) {
+	bail_with_error("Not enough space for the batch's jobs!");
+    }
+    return ret;
+}
+
+// Read the whole file named name into a new buffer (with a null
+// character after its contents), setting *buf to the buffer
+// and *len to its length, and return true;
+// if the file cannot be read, put the reason in message
+// (which has size bytes) and return false
+static bool read_file(const char *name, char **buf, size_t *len,
+		      char *message, size_t size)
+{
+    FILE *f = fopen(name, "rb");
+    if (f == NULL) {
+	snprintf(message, size, "Cannot open file '%s': %s", name,
+		 strerror(errno));
+	return false;
+    }
+    size_t cap = 4096;
+    *len = 0;
+    *buf = (char *) malloc(cap);
+    while (*buf != NULL) {
+	*len += fread(*buf + *len, 1, cap - *len - 1, f);
+	if (*len < cap - 1) {
+	    break;
+	}
+	cap *= 2;
+	char *bigger = (char *) realloc(*buf, cap);
+	if (bigger == NULL) {
+	    free(*buf);
+	}
+	*buf = bigger;
+    }
+    bool ok = (*buf != NULL) && !ferror(f);
+    if (*buf == NULL) {
+	snprintf(message, size, "Not enough space for file '%s'", name);
+    } else if (!ok) {
+	snprintf(message, size, "Cannot read file '%s': %s", name,
+		 strerror(errno));
+	free(*buf);
+	*buf = NULL;
+    } else {
+	(*buf)[*len] = '\0';
+    }
+    fclose(f);
+    return ok;
+}
+
+// Add a job for the program in the file named program
+// (reading from the file named input, or nothing if input is NULL)
+static void add_job(const char *program, const char *input)
+{
+    if (num_jobs == BATCH_MAX_JOBS) {
+	bail_with_error("Too many jobs (more than %d)!", BATCH_MAX_JOBS);
+    }
+    batch_job *job = &jobs[num_jobs++];
+    job->program = copy_string(program);
+    job->input = (input == NULL) ? NULL : copy_string(input);
+    job->halted = false;
+    job->instructions = 0;
+    job->millis = 0.0;
+    job->message = NULL;
+}
+
+// Read the jobs from the manifest named name
+static void read_manifest(const char *name)
+{
+    char *text;
+    size_t len;
+    char message[ERROR_MESSAGE_SIZE];
+    if (!read_file(name, &text, &len, message, sizeof(message))) {
+	// the message already says why
+	errno = 0;
+	bail_with_error("%s", message);
+    }
+    // there are at most as many jobs as lines
+    int lines = 1;
+    for (size_t i = 0; i < len; i++) {
+	lines += (text[i] == '\n');
+    }
+    jobs = allocate(lines, sizeof(batch_job));
+    char *save_line;
+    for (char *line = strtok_r(text, "\n", &save_line); line != NULL;
+	 line = strtok_r(NULL, "\n", &save_line)) {
+	char *save_word;
+	char *program = strtok_r(line, " \t\r", &save_word);
+	if (program == NULL || program[0] == '#') {
+	    continue;
+	}
+	char *input = strtok_r(NULL, " \t\r", &save_word);
+	if (strtok_r(NULL, " \t\r", &save_word) != NULL) {
+	    bail_with_error("Too many file names for the job '%s'"
+			    " in manifest '%s'", program, name);
+	}
+	add_job(program, input);
+    }
+    free(text);
+}
+
+// Does the string s end with suffix?
+static bool ends_with(const char *s, const char *suffix)
+{
+    size_t n = strlen(s);
+    size_t m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// Compare the strings that a and b point to
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+// Make a job for each program in the directory named name
+static void read_directory(const char *name)
+{
+    DIR *dir = opendir(name);
+    if (dir == NULL) {
+	bail_with_error("Cannot open directory '%s'", name);
+    }
+    int cap = 64;
+    int count = 0;
+    char **names = allocate(cap, sizeof(char *));
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+	if (!ends_with(ent->d_name, ".vmi")
+	    && !ends_with(ent->d_name, ".myvi")
+	    && !ends_with(ent->d_name, ".myvb")) {
+	    continue;
+	}
+	if (count == BATCH_MAX_JOBS) {
+	    bail_with_error("Too many jobs (more than %d)!", BATCH_MAX_JOBS);
+	}
+	if (count == cap) {
+	    cap *= 2;
+	    names = (char **) realloc(names, cap * sizeof(char *));
+	    if (names == NULL) {
+		bail_with_error("Not enough space for the batch's jobs!");
+	    }
+	}
+	names[count] = allocate(strlen(name) + strlen(ent->d_name) + 2, 1);
+	sprintf(names[count], "%s/%s", name, ent->d_name);
+	count++;
+    }
+    closedir(dir);
+    errno = 0;
+    qsort(names, count, sizeof(char *), compare_names);
+    jobs = allocate(count > 0 ? count : 1, sizeof(batch_job));
+    for (int i = 0; i < count; i++) {
+	char *input = allocate(strlen(names[i]) + 4, 1);
+	sprintf(input, "%s.in", names[i]);
+	struct stat st;
+	add_job(names[i], (stat(input, &st) == 0) ? input : NULL);
+	free(input);
+	free(names[i]);
+    }
+    errno = 0;
+    free(names);
+}
+
+// The read hook of each worker's VM: read from the job's input
+static ssize_t read_input(void *arg, char *buf, size_t size)
+{
+    batch_worker *w = (batch_worker *) arg;
+    size_t n = w->in_len - w->in_next;
+    if (n > size) {
+	n = size;
+    }
+    if (n > 0) {
+	memcpy(buf, w->in + w->in_next, n);
+	w->in_next += n;
+    }
+    return n;
+}
+
+// The write hook of each worker's VM: add to the job's output
+static ssize_t write_output(void *arg, const char *buf, size_t size)
+{
+    batch_worker *w = (batch_worker *) arg;
+    if (w->out_len + size > w->out_cap) {
+	size_t cap = (w->out_cap == 0) ? 4096 : w->out_cap;
+	while (w->out_len + size > cap) {
+	    cap *= 2;
+	}
+	char *bigger = (char *) realloc(w->out, cap);
+	if (bigger == NULL) {
+	    return -1;
+	}
+	w->out = bigger;
+	w->out_cap = cap;
+    }
+    memcpy(w->out + w->out_len, buf, size);
+    w->out_len += size;
+    return size;
+}
+
+// Write the output of job (in w's output buffer) to its file
+// in the output directory, returning false if that fails
+static bool save_output(batch_worker *w, batch_job *job)
+{
+    const char *base = strrchr(job->program, '/');
+    base = (base == NULL) ? job->program : base + 1;
+    char name[ERROR_MESSAGE_SIZE];
+    snprintf(name, sizeof(name), "%s/%s.out", output_dir, base);
+    FILE *f = fopen(name, "wb");
+    if (f == NULL) {
+	return false;
+    }
+    bool ok = fwrite(w->out, 1, w->out_len, f) == w->out_len;
+    return (fclose(f) == 0) && ok;
+}
+
+// Return the number of milliseconds from start to end
+static double elapsed_millis(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3
+	+ (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Run job in w's VM, recording what happened
+static void run_job(batch_worker *w, batch_job *job)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char message[ERROR_MESSAGE_SIZE] = "";
+    char *prog = NULL;
+    size_t prog_len = 0;
+    w->in = NULL;
+    w->in_len = 0;
+    w->in_next = 0;
+    w->out_len = 0;
+    if (read_file(job->program, &prog, &prog_len, message, sizeof(message))
+	&& (job->input == NULL
+	    || read_file(job->input, &w->in, &w->in_len, message,
+			 sizeof(message)))) {
+	if (vm_load(w->vm, prog, prog_len)) {
+	    job->halted = (vm_run(w->vm, 0) == vm_halted);
+	    job->instructions = vm_instruction_count(w->vm);
+	}
+	if (!job->halted) {
+	    snprintf(message, sizeof(message), "%s", vm_error_message(w->vm));
+	}
+    }
+    free(prog);
+    free(w->in);
+    if (!job->halted) {
+	job->message = copy_string(message);
+	write_output(w, message, strlen(message));
+	write_output(w, "\n", 1);
+    }
+    if (output_dir != NULL && !save_output(w, job)) {
+	if (job->halted) {
+	    job->halted = false;
+	    snprintf(message, sizeof(message),
+		     "Cannot write the output to directory '%s': %s",
+		     output_dir, strerror(errno));
+	    job->message = copy_string(message);
+	}
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    job->millis = elapsed_millis(&start, &end);
+}
+
+// Take the next job from w's queue, or steal one from another worker's,
+// returning its index, or -1 if there are none left anywhere
+static int next_job(batch_worker *w)
+{
+    int j = -1;
+    pthread_mutex_lock(&w->lock);
+    if (w->head < w->tail) {
+	j = w->queue[--w->tail];
+    }
+    pthread_mutex_unlock(&w->lock);
+    // no jobs are added once the workers start,
+    // so once every queue is empty, all the jobs have been taken
+    int me = w - workers;
+    for (int i = 1; j < 0 && i < num_workers; i++) {
+	batch_worker *victim = &workers[(me + i) % num_workers];
+	pthread_mutex_lock(&victim->lock);
+	if (victim->head < victim->tail) {
+	    j = victim->queue[victim->head++];
+	}
+	pthread_mutex_unlock(&victim->lock);
+    }
+    return j;
+}
+
+// The body of each worker's thread: run jobs until there are none left
+static void *work(void *arg)
+{
+    batch_worker *w = (batch_worker *) arg;
+    for (int j = next_job(w); j >= 0; j = next_job(w)) {
+	run_job(w, &jobs[j]);
+    }
+    return NULL;
+}
+
+// Set up the workers, with the jobs divided evenly among their queues
+static void create_workers(int threads)
+{
+    num_workers = (threads < num_jobs) ? threads : num_jobs;
+    if (num_workers == 0) {
+	num_workers = 1;
+    }
+    workers = allocate(num_workers, sizeof(batch_worker));
+    for (int i = 0; i < num_workers; i++) {
+	batch_worker *w = &workers[i];
+	int first = (int) ((long) num_jobs * i / num_workers);
+	int last = (int) ((long) num_jobs * (i+1) / num_workers);
+	pthread_mutex_init(&w->lock, NULL);
+	w->queue = allocate(last - first + 1, sizeof(int));
+	w->head = 0;
+	w->tail = 0;
+	// the owner takes from the tail, so it runs its jobs in order
+	for (int j = last - 1; j >= first; j--) {
+	    w->queue[w->tail++] = j;
+	}
+	w->vm = vm_create();
+	if (w->vm == NULL) {
+	    bail_with_error("Not enough space for the batch's VMs!");
+	}
+	vm_set_io(w->vm, read_input, write_output, w);
+	if (!vm_set_engine(w->vm, run_engine)) {
+	    bail_with_error("There is no JIT engine on this machine!");
+	}
+	// counting runs each instruction on its own (unless in the
+	// switch engine), so it is only done when asked for
+	vm_set_counting(w->vm, counting);
+	if (max_stack_height > 0) {
+	    vm_set_stack_height(w->vm, max_stack_height);
+	}
+	vm_set_fuel(w->vm, max_fuel);
+    }
+}
+
+// Print the report of the jobs on stdout
+static void print_report(double total_millis)
+{
+    int failed = 0;
+    // every worker's VM has the same options
+    bool counted = vm_instructions_counted(workers[0].vm);
+    printf("%-7s %12s %10s  %s\n", "Status", "Instructions", "Time (ms)",
+	   "Program");
+    for (int i = 0; i < num_jobs; i++) {
+	batch_job *job = &jobs[i];
+	char instructions[32] = "-";
+	if (counted) {
+	    snprintf(instructions, sizeof(instructions), "%lu",
+		     job->instructions);
+	}
+	printf("%-7s %12s %10.3f  %s", job->halted ? "halted" : "failed",
+	       instructions, job->millis, job->program);
+	if (job->message != NULL) {
+	    printf(": %s", job->message);
+	}
+	printf("\n");
+	failed += !job->halted;
+    }
+    printf("%d jobs, %d failed, in %.3f ms on %d threads"
+	   " in the %s engine\n", num_jobs, failed, total_millis,
+	   num_workers, vm_engine_name(workers[0].vm));
+}
+
+// Run the jobs in the manifest or directory named jobs_name
+int batch_run(const char *jobs_name, int threads, const char *out_dir,
+	      int stack_height, unsigned long fuel, engine_kind engine,
+	      bool count)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    output_dir = out_dir;
+    max_stack_height = stack_height;
+    max_fuel = fuel;
+    run_engine = engine;
+    counting = count;
+    struct stat st;
+    if (stat(jobs_name, &st) != 0) {
+	bail_with_error("Cannot open file '%s'", jobs_name);
+    }
+    if (S_ISDIR(st.st_mode)) {
+	read_directory(jobs_name);
+    } else {
+	read_manifest(jobs_name);
+    }
+    create_workers(threads);
+    // the first worker runs on this thread
+    for (int i = 1; i < num_workers; i++) {
+	errno = pthread_create(&workers[i].thread, NULL, work, &workers[i]);
+	if (errno != 0) {
+	    bail_with_error("Cannot create a thread for the batch");
+	}
+    }
+    work(&workers[0]);
+    for (int i = 1; i < num_workers; i++) {
+	pthread_join(workers[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    print_report(elapsed_millis(&start, &end));
+
+    bool all_halted = true;
+    for (int i = 0; i < num_jobs; i++) {
+	all_halted = all_halted && jobs[i].halted;
+	free(jobs[i].program);
+	free(jobs[i].input);
+	free(jobs[i].message);
+    }
+    free(jobs);
+    for (int i = 0; i < num_workers; i++) {
+	vm_destroy(workers[i].vm);
+	free(workers[i].queue);
+	free(workers[i].out);
+	pthread_mutex_destroy(&workers[i].lock);
+    }
+    free(workers);
+    return all_halted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+#ifndef _BATCH_H
+#define _BATCH_H
+#include <stdbool.h>
+#include "vm_api.h"
+
+// The batch runner (vm --batch) runs many programs in one process,
+// each in its own VM (see vm_api.h), spread over a number of threads.
+//
+// The jobs come from a manifest, a text file with one job per line:
+// the name of a program file (in the text or bytecode format),
+// optionally followed by the name of the file its CHI instructions
+// read from (otherwise they read nothing); blank lines and lines
+// starting with # are ignored.
+// Instead of a manifest, a directory can be given: its files whose
+// names end in .vmi, .myvi, or .myvb are the programs (in the order
+// of their names), and each reads from the file with its name
+// followed by .in, if there is one.
+//
+// Each thread takes jobs from its own queue and, when that is empty,
+// steals from the others' queues, reusing its VM for each job.
+// A job's output (what its CHO instructions write, followed by its
+// error message, as the vm program would print with -n) is kept
+// in memory, and written to the file out_dir/NAME.out,
+// where NAME is the last part of the program's file name
+// (or dropped, if out_dir is NULL).
+// When all the jobs are done, a report is printed on stdout
+// with one line for each job (in the order they were given):
+// its status (halted or failed), the number of instructions it
+// executed (or - if they were not counted), its wall time
+// in milliseconds, its program, and its error message (if it failed),
+// followed by a summary that names the engine the jobs ran in.
+// Instructions are counted only when asked for (vm --batch --count),
+// as counting runs each instruction on its own in the checked engine
+// (see vm_set_counting), except in the switch engine, which always
+// counts them.
+
+// the most jobs a manifest or directory can have
+#define BATCH_MAX_JOBS 1000000
+
+// Requires: threads > 0 and (stack_height == 0 or
+//           0 < stack_height <= STACK_CAPACITY)
+// Run the jobs in the manifest or directory named jobs_name
+// on the given number of threads, with stacks of the given maximum
+// height (or of the default height, if stack_height is 0),
+// each limited to the given fuel (see vm_set_fuel; 0 for no limit),
+// in the given engine, counting their instructions if count is true,
+// and print the report; return EXIT_SUCCESS if every job halted,
+// and EXIT_FAILURE otherwise.
+extern int batch_run(const char *jobs_name, int threads,
+		     const char *out_dir, int stack_height,
+		     unsigned long fuel, engine_kind engine, bool count);
+#endif
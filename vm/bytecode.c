@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "instruction.h"
+#include "utilities.h"
+#include "bytecode.h"
+
+// the instructions are copied directly from the file
+_Static_assert(sizeof(instruction) == BYTECODE_INSTR_SIZE,
+	       "instruction must be two 32-bit integers");
+
+// Report the error described by fmt (as for bail_with_error)
+// in the size bytes at start, unmapping them first if mapped is true
+// (as they are when the error is trapped, so they are not leaked)
+static void malformed(const char *start, size_t size, bool mapped,
+		      const char *fmt, ...)
+{
+    char msg[ERROR_MESSAGE_SIZE];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    if (mapped) {
+	int saved_errno = errno;
+	munmap((void *) start, size);
+	errno = saved_errno;
+    }
+    bail_with_error("%s", msg);
+}
+
+// Requires: the size bytes at start are readable
+// Check that the sections (num_sections of them, starting at offset off)
+// lie inside the size bytes at start, bailing if not.
+static void check_sections(const char *filename, const char *start,
+			   size_t size, bool mapped, size_t off,
+			   uint32_t num_sections)
+{
+    for (uint32_t i = 0; i < num_sections; i++) {
+	bytecode_section sect;
+	if (size - off < sizeof(sect)) {
+	    malformed(start, size, mapped,
+		      "Truncated section header in bytecode file '%s'",
+		      filename);
+	}
+	memcpy(&sect, start + off, sizeof(sect));
+	off += sizeof(sect);
+	size_t padded = ((size_t) sect.length + 3) / 4 * 4;
+	if (size - off < padded) {
+	    malformed(start, size, mapped,
+		      "Truncated section in bytecode file '%s'", filename);
+	}
+	// there are no sections the VM needs yet, so all are skipped
+	off += padded;
+    }
+}
+
+// Requires: the size bytes at start are readable
+// If the size bytes at start (from the file or buffer named name,
+// mapped by bytecode_load if mapped is true) are in the bytecode format,
+// check that they are well formed, set *hdr to their header,
+// and return true; otherwise return false.
+static bool parse(const char *name, const char *start, size_t size,
+		  bool mapped, bytecode_header *hdr)
+{
+    if (size < sizeof(*hdr)) {
+	return false;
+    }
+    memcpy(hdr, start, sizeof(*hdr));
+    if (memcmp(hdr->magic, BYTECODE_MAGIC, BYTECODE_MAGIC_SIZE) != 0) {
+	return false;
+    }
+
+    if (hdr->version != BYTECODE_VERSION) {
+	malformed(start, size, mapped,
+		  "Unsupported version (%u) of bytecode file '%s'",
+		  hdr->version, name);
+    }
+    if (hdr->header_size < sizeof(*hdr) || hdr->header_size > size
+	|| hdr->header_size % 4 != 0) {
+	malformed(start, size, mapped,
+		  "Bad header size (%u) in bytecode file '%s'",
+		  hdr->header_size, name);
+    }
+    if (hdr->num_instrs > INT32_MAX / BYTECODE_INSTR_SIZE) {
+	malformed(start, size, mapped,
+		  "Too many instructions (%u) in bytecode file '%s'",
+		  hdr->num_instrs, name);
+    }
+    size_t code_bytes = (size_t) hdr->num_instrs * BYTECODE_INSTR_SIZE;
+    if (size - hdr->header_size < code_bytes) {
+	malformed(start, size, mapped,
+		  "Truncated instructions in bytecode file '%s'", name);
+    }
+    if (hdr->entry >= hdr->num_instrs && hdr->num_instrs > 0) {
+	malformed(start, size, mapped, "Entry point (%u) is outside the code"
+		  " in bytecode file '%s'", hdr->entry, name);
+    }
+    check_sections(name, start, size, mapped, hdr->header_size + code_bytes,
+		   hdr->num_sections);
+    return true;
+}
+
+// Requires: parse returned true for the size bytes at start,
+// whose header is hdr
+// Check that each of their instructions (from the file or buffer
+// named name, mapped if mapped is true) has a legal opcode, bailing if not
+static void check_opcodes(const char *name, const char *start, size_t size,
+			  bool mapped, const bytecode_header *hdr)
+{
+    const char *instrs = start + hdr->header_size;
+    for (uint32_t i = 0; i < hdr->num_instrs; i++) {
+	instruction instr;
+	memcpy(&instr, instrs + i * BYTECODE_INSTR_SIZE, sizeof(instr));
+	if (!legal_op_code(instr.op)) {
+	    malformed(start, size, mapped, "Illegal opcode (%d) at address %u"
+		      " in bytecode file '%s'", instr.op, i, name);
+	}
+    }
+}
+
+// If the file named filename is in the bytecode format,
+// set *code to its (mapped) instructions, set *entry to its entry point,
+// set *mapping and *mapping_size to the mapping,
+// and return the number of instructions; otherwise return -1.
+int bytecode_load(const char *filename, instruction **code, int *entry,
+		  const void **mapping, size_t *mapping_size)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(bytecode_header)) {
+	close(fd);
+	return -1;
+    }
+    size_t size = st.st_size;
+    const char *start = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (start == MAP_FAILED) {
+	return -1;
+    }
+    bytecode_header hdr;
+    if (!parse(filename, start, size, true, &hdr)) {
+	munmap((void *) start, size);
+	return -1;
+    }
+    check_opcodes(filename, start, size, true, &hdr);
+    // the header's size is a multiple of 4 (and the mapping starts
+    // on a page boundary), so the instructions are aligned
+    *code = (instruction *) (start + hdr.header_size);
+    *entry = hdr.entry;
+    *mapping = start;
+    *mapping_size = size;
+    return hdr.num_instrs;
+}
+
+// Unmap the mapping (of mapping_size bytes) made by bytecode_load
+void bytecode_unload(const void *mapping, size_t mapping_size)
+{
+    munmap((void *) mapping, mapping_size);
+}
+
+// If the size bytes in buf are in the bytecode format,
+// set *code to a copy of its instructions, set *entry to its entry point,
+// and return the number of instructions; otherwise return -1.
+int bytecode_load_buffer(const char *buf, size_t size, instruction **code,
+			 int *entry)
+{
+    const char *name = "(buffer)";
+    bytecode_header hdr;
+    if (!parse(name, buf, size, false, &hdr)) {
+	return -1;
+    }
+    check_opcodes(name, buf, size, false, &hdr);
+    // buf may not be aligned, so the instructions are copied
+    instruction *instrs = (instruction *)
+	malloc(sizeof(instruction) * (hdr.num_instrs + 1));
+    if (instrs == NULL) {
+	bail_with_error("Not enough space for %u instructions!",
+			hdr.num_instrs);
+    }
+    memcpy(instrs, buf + hdr.header_size,
+	   (size_t) hdr.num_instrs * BYTECODE_INSTR_SIZE);
+    *code = instrs;
+    *entry = hdr.entry;
+    return hdr.num_instrs;
+}
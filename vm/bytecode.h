@@ -0,0 +1,76 @@
+#ifndef _BYTECODE_H
+#define _BYTECODE_H
+#include <stddef.h>
+#include <stdint.h>
+#include "instruction.h"
+
+// The binary (bytecode) format for programs, an alternative
+// to the VM's text format that can be loaded without parsing.
+// (The compiler's bytecode.h describes the same format.)
+//
+// A bytecode file consists of
+//  - a header (bytecode_header),
+//  - num_instrs instructions, each two 32-bit integers (op, then M),
+//    starting at offset header_size,
+//  - num_sections optional sections, each a bytecode_section
+//    followed by its data, padded with zeros to a multiple of 4 bytes.
+// All integers are in the byte order of the machine that
+// wrote the file; a file from a machine with the other byte order
+// is rejected because its magic number and version do not match.
+// Sections with unknown tags are skipped, so new kinds of sections
+// can be added without changing the version.
+
+// the first 4 bytes of each bytecode file
+#define BYTECODE_MAGIC "PL0B"
+#define BYTECODE_MAGIC_SIZE 4
+
+// the version of the format described above
+#define BYTECODE_VERSION 1
+
+typedef struct {
+    char magic[BYTECODE_MAGIC_SIZE]; // BYTECODE_MAGIC (not 0 terminated)
+    uint32_t version;      // BYTECODE_VERSION
+    uint32_t header_size;  // size of the header in bytes
+    uint32_t num_instrs;   // number of instructions
+    uint32_t entry;        // address of the first instruction to execute
+    uint32_t num_sections; // number of sections after the instructions
+} bytecode_header;
+
+// the tags of the known sections
+// the name of the source file the program was compiled from
+#define BYTECODE_SECTION_SOURCE 1
+
+typedef struct {
+    uint32_t tag;    // what the section holds
+    uint32_t length; // length of the data in bytes (without padding)
+} bytecode_section;
+
+// the size of each instruction in a bytecode file
+#define BYTECODE_INSTR_SIZE (2 * sizeof(int32_t))
+
+// If the file named filename is in the bytecode format,
+// map it into memory, set *code to its instructions (which are used
+// where they are in the mapping, and stay mapped until it is given
+// to bytecode_unload), set *entry to its entry point,
+// set *mapping and *mapping_size to the start and size of the mapping,
+// and return the number of instructions;
+// if the file cannot be opened or is not in the bytecode format
+// (does not start with BYTECODE_MAGIC), return -1.
+// A bytecode file that is malformed is unmapped and then reported
+// with bail_with_error.
+extern int bytecode_load(const char *filename, instruction **code,
+			 int *entry, const void **mapping,
+			 size_t *mapping_size);
+
+// Requires: mapping and mapping_size were set by bytecode_load
+// Unmap the file mapped by bytecode_load (so its instructions
+// can no longer be used)
+extern void bytecode_unload(const void *mapping, size_t mapping_size);
+
+// Requires: buf has size bytes
+// Like bytecode_load, but for the program in buf (as read from
+// a bytecode file); the instructions are copied into a new array
+// (allocated with malloc) instead of being mapped.
+extern int bytecode_load_buffer(const char *buf, size_t size,
+				instruction **code, int *entry);
+#endif
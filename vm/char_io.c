@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "utilities.h"
+#include "char_io.h"
+
+// the default read hook, which reads from the standard input
+static ssize_t read_stdin(void *arg, char *buf, size_t size)
+{
+    return read(0, buf, size);
+}
+
+// the default write hook, which writes to the standard output
+static ssize_t write_stdout(void *arg, const char *buf, size_t size)
+{
+    return write(1, buf, size);
+}
+
+// Set up io to use the standard input and output
+void char_io_create(char_io *io)
+{
+    io->read = read_stdin;
+    io->write = write_stdout;
+    io->read_arg = NULL;
+    io->write_arg = NULL;
+    io->out_buf = NULL;
+    io->out_size = CHAR_IO_BUFFER_SIZE;
+    io->out_len = 0;
+    io->policy = flush_when_full;
+    io->policy_set = false;
+    io->in_buf = NULL;
+    io->in_next = 0;
+    io->in_len = 0;
+    io->in_eof = false;
+    io->interactive = false;
+    io->recording = false;
+    io->log = NULL;
+    io->log_len = 0;
+    io->log_cap = 0;
+    io->in_logged = 0;
+}
+
+// Give back io's buffers
+void char_io_destroy(char_io *io)
+{
+    free(io->out_buf);
+    free(io->in_buf);
+    free(io->log);
+    io->out_buf = NULL;
+    io->in_buf = NULL;
+    io->log = NULL;
+}
+
+// Requires: char_io_initialize has not been called on io
+// Make io use the given hooks
+void char_io_set_hooks(char_io *io, char_io_read_fn read,
+		       char_io_write_fn write, void *arg)
+{
+    io->read = read;
+    io->write = write;
+    io->read_arg = arg;
+    io->write_arg = arg;
+}
+
+// Requires: char_io_initialize has not been called on io
+// Make io read with the given hook
+void char_io_set_read_hook(char_io *io, char_io_read_fn read, void *arg)
+{
+    io->read = read;
+    io->read_arg = arg;
+}
+
+// Requires: size > 0 and char_io_initialize has not been called on io
+// Set the size of the output buffer
+void char_io_set_buffer_size(char_io *io, size_t size)
+{
+    io->out_size = size;
+}
+
+// Set the flush policy
+void char_io_set_flush_policy(char_io *io, flush_policy pol)
+{
+    io->policy = pol;
+    io->policy_set = true;
+}
+
+// Return a new buffer of the given size, bailing if there is no space
+static char *allocate_buffer(size_t size)
+{
+    char *ret = (char *) malloc(size);
+    if (ret == NULL) {
+	bail_with_error("Not enough space for an I/O buffer of %zu bytes",
+			size);
+    }
+    return ret;
+}
+
+// Set up the buffers and start reading the input afresh
+void char_io_initialize(char_io *io)
+{
+    io->out_len = 0;
+    io->in_next = 0;
+    io->in_len = 0;
+    io->in_eof = false;
+    io->log_len = 0;
+    io->in_logged = 0;
+    if (io->out_buf != NULL) {
+	return;
+    }
+    io->out_buf = allocate_buffer(io->out_size);
+    io->in_buf = allocate_buffer(CHAR_IO_BUFFER_SIZE);
+    io->interactive = (io->read == read_stdin) && isatty(0);
+    if (!io->policy_set) {
+	io->policy = (io->write == write_stdout && isatty(1))
+	    ? flush_each_line : flush_when_full;
+    }
+    // isatty sets errno when the answer is no,
+    // which would otherwise show up in later error messages
+    errno = 0;
+}
+
+// Write out the characters in the output buffer;
+// like stdio at exit, output that cannot be written is dropped
+void char_io_flush(char_io *io)
+{
+    size_t done = 0;
+    while (done < io->out_len) {
+	ssize_t n = io->write(io->write_arg, io->out_buf + done,
+			      io->out_len - done);
+	if (n < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (n <= 0) {
+	    break;
+	}
+	done += n;
+    }
+    io->out_len = 0;
+}
+
+// Output the character c (converted to an unsigned char)
+void char_io_put(char_io *io, int c)
+{
+    if (io->out_len == io->out_size) {
+	char_io_flush(io);
+    }
+    io->out_buf[io->out_len++] = (unsigned char) c;
+    if (io->policy == flush_each_char
+	|| (io->policy == flush_each_line && (unsigned char) c == '\n')) {
+	char_io_flush(io);
+    }
+}
+
+// Append the characters in the input buffer that have been returned
+// but are not in io's log yet to the log
+static void log_returned(char_io *io)
+{
+    size_t n = io->in_next - io->in_logged;
+    if (io->log_len + n > io->log_cap) {
+	size_t cap = (io->log_cap == 0) ? CHAR_IO_BUFFER_SIZE : io->log_cap;
+	while (io->log_len + n > cap) {
+	    cap *= 2;
+	}
+	io->log = (char *) realloc(io->log, cap);
+	if (io->log == NULL) {
+	    bail_with_error("Not enough space to record %zu input characters",
+			    cap);
+	}
+	io->log_cap = cap;
+    }
+    memcpy(io->log + io->log_len, io->in_buf + io->in_logged, n);
+    io->log_len += n;
+    io->in_logged = io->in_next;
+}
+
+// Return the next input character, or EOF if there is no more input
+int char_io_get(char_io *io)
+{
+    if (io->in_next == io->in_len) {
+	if (io->in_eof) {
+	    return EOF;
+	}
+	if (io->recording) {
+	    // the whole buffer has been returned, and is refilled below
+	    log_returned(io);
+	}
+	if (io->interactive) {
+	    // show any prompt before waiting for the user
+	    char_io_flush(io);
+	}
+	ssize_t n;
+	do {
+	    n = io->read(io->read_arg, io->in_buf, CHAR_IO_BUFFER_SIZE);
+	} while (n < 0 && errno == EINTR);
+	if (n <= 0) {
+	    io->in_eof = true;
+	    return EOF;
+	}
+	io->in_next = 0;
+	io->in_len = n;
+	io->in_logged = 0;
+    }
+    return (unsigned char) io->in_buf[io->in_next++];
+}
+
+// Keep each character that char_io_get returns from now on
+void char_io_record(char_io *io)
+{
+    io->recording = true;
+}
+
+// Return the characters char_io_get has returned since io was initialized
+const char *char_io_recorded(char_io *io, size_t *len, bool *ended)
+{
+    if (io->in_buf != NULL) {
+	log_returned(io);
+    }
+    *len = io->log_len;
+    *ended = io->in_eof;
+    return io->log;
+}
@@ -0,0 +1,127 @@
+#ifndef _CHAR_IO_H
+#define _CHAR_IO_H
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// The character I/O done by the CHO and CHI instructions.
+// Output is collected in a buffer and written out in large blocks;
+// input is read ahead in large blocks.
+// By default the output goes to the standard output (file descriptor 1)
+// and the input comes from the standard input (file descriptor 0),
+// but each VM can have its own hooks (see char_io_set_hooks).
+// Nothing else in the VM writes to the standard output.
+
+// when the output buffer is written out (besides when it is full,
+// when the machine halts, before an error message,
+// and before CHI waits for input from a terminal)
+typedef enum {
+    flush_when_full,  // only then
+    flush_each_line,  // also after each newline character
+    flush_each_char   // after every character
+} flush_policy;
+
+// the default size of the output and input buffers, in bytes
+#define CHAR_IO_BUFFER_SIZE 65536
+
+// A hook that reads up to size bytes into buf, as read(2) does:
+// it returns the number of bytes read, 0 at the end of the input,
+// or a negative number on an error
+typedef ssize_t (*char_io_read_fn)(void *arg, char *buf, size_t size);
+
+// A hook that writes up to size bytes from buf, as write(2) does:
+// it returns the number of bytes written, or a negative number
+// on an error
+typedef ssize_t (*char_io_write_fn)(void *arg, const char *buf, size_t size);
+
+// the character I/O of one VM; its fields are only used
+// by the functions below
+typedef struct {
+    // the hooks, and the arguments passed to them
+    char_io_read_fn read;
+    char_io_write_fn write;
+    void *read_arg;
+    void *write_arg;
+    // the output buffer, of out_size bytes,
+    // with out_len characters waiting to be written
+    char *out_buf;
+    size_t out_size;
+    size_t out_len;
+    // the flush policy, and whether it was set by char_io_set_flush_policy
+    flush_policy policy;
+    bool policy_set;
+    // the input buffer, holding the characters from in_next to in_len
+    // that have been read but not yet returned
+    char *in_buf;
+    size_t in_next;
+    size_t in_len;
+    // has the end of the input been reached?
+    bool in_eof;
+    // does the input come from a terminal?
+    bool interactive;
+    // keep the characters returned as input (see char_io_record)?
+    bool recording;
+    // the characters returned, up to the start of the input buffer
+    // (log_len of them, with room for log_cap), and how many of those
+    // in the input buffer are already in the log
+    char *log;
+    size_t log_len;
+    size_t log_cap;
+    size_t in_logged;
+} char_io;
+
+// Set up io to use the standard input and output,
+// with the default buffer size and no buffers yet
+extern void char_io_create(char_io *io);
+
+// Give back io's buffers
+extern void char_io_destroy(char_io *io);
+
+// Requires: char_io_initialize has not been called on io
+// Make io read and write with the given hooks (passing them arg)
+// instead of the standard input and output
+extern void char_io_set_hooks(char_io *io, char_io_read_fn read,
+			      char_io_write_fn write, void *arg);
+
+// Requires: char_io_initialize has not been called on io
+// Make io read with the given hook (passing it arg)
+// instead of the one it has, keeping its write hook
+extern void char_io_set_read_hook(char_io *io, char_io_read_fn read,
+				  void *arg);
+
+// Requires: size > 0 and char_io_initialize has not been called on io
+// Set the size of the output buffer (CHAR_IO_BUFFER_SIZE by default)
+extern void char_io_set_buffer_size(char_io *io, size_t size);
+
+// Set the flush policy (by default, flush_each_line if the output
+// is the standard output and it is a terminal, and flush_when_full
+// otherwise)
+extern void char_io_set_flush_policy(char_io *io, flush_policy policy);
+
+// Set up the buffers (if that was not done already)
+// and start reading the input afresh
+extern void char_io_initialize(char_io *io);
+
+// Write out the characters in the output buffer
+extern void char_io_flush(char_io *io);
+
+// Output the character c (converted to an unsigned char), as CHO does
+extern void char_io_put(char_io *io, int c);
+
+// Return the next input character (as an unsigned char),
+// or EOF if there is no more input, as CHI does
+extern int char_io_get(char_io *io);
+
+// Keep each character that char_io_get returns from now on
+// (and from each time io is initialized), to be given by
+// char_io_recorded; this costs nothing for each character,
+// only a copy of the input buffer each time it is refilled
+extern void char_io_record(char_io *io);
+
+// Requires: char_io_record has been called on io
+// Return the characters char_io_get has returned since io was
+// initialized, setting *len to their number and *ended to whether
+// it has also returned EOF (the array belongs to io, and is only
+// good until io is used again)
+extern const char *char_io_recorded(char_io *io, size_t *len, bool *ended);
+#endif
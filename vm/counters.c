@@ -0,0 +1,266 @@
+// for syscall
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "counters.h"
+
+// the names of the hardware events, as the report gives them
+static const char *counter_names[NUM_COUNTERS] = {
+    "cycles", "instructions", "branch misses", "L1d read misses"
+};
+
+// Set up c, not counting
+void counters_create(counters_data *c)
+{
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+	c->fds[i] = -1;
+	c->values[i] = 0;
+    }
+    c->open_error = -1;
+    c->wall_seconds = 0.0;
+    c->cpu_seconds = 0.0;
+    c->running = false;
+    c->finished = false;
+}
+
+// Close c's counters
+void counters_destroy(counters_data *c)
+{
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+	if (c->fds[i] >= 0) {
+	    close(c->fds[i]);
+	    c->fds[i] = -1;
+	}
+    }
+}
+
+#ifdef __linux__
+// what a read of one counter gives (see read_format below)
+typedef struct {
+    unsigned long long value;
+    unsigned long long time_enabled;
+    unsigned long long time_running;
+} counter_reading;
+
+// Open the counter for the hardware event kind, in the group led
+// by the counter group_fd (or leading a new one, if group_fd is -1),
+// returning its file descriptor, or -1 (with errno set) if that fails
+static int open_counter(counter_kind kind, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (kind) {
+    case counter_cycles:
+	attr.config = PERF_COUNT_HW_CPU_CYCLES;
+	break;
+    case counter_instructions:
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	break;
+    case counter_branch_misses:
+	attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+	break;
+    default:
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = PERF_COUNT_HW_CACHE_L1D
+	    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+	    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	break;
+    }
+    // only the group's leader is started and stopped
+    attr.disabled = (group_fd < 0);
+    // the VM's own work: what the kernel does (as for I/O)
+    // is not counted, which also lets users without privileges count
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // to scale the count if the counter was not always running
+    // (when the kernel had to share the hardware between counters)
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+	| PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Open c's counters, noting why the hardware cannot be used, if not
+static void open_counters(counters_data *c)
+{
+    c->fds[counter_cycles] = open_counter(counter_cycles, -1);
+    if (c->fds[counter_cycles] < 0) {
+	c->open_error = errno;
+    } else {
+	c->open_error = 0;
+	for (int i = counter_cycles + 1; i < NUM_COUNTERS; i++) {
+	    // an event this processor does not have is left out
+	    c->fds[i] = open_counter(i, c->fds[counter_cycles]);
+	}
+    }
+    // errors in the program must not show these
+    errno = 0;
+}
+
+// Start c's counters (as a group) from 0
+static void enable_counters(counters_data *c)
+{
+    if (c->fds[counter_cycles] >= 0) {
+	ioctl(c->fds[counter_cycles], PERF_EVENT_IOC_RESET,
+	      PERF_IOC_FLAG_GROUP);
+	ioctl(c->fds[counter_cycles], PERF_EVENT_IOC_ENABLE,
+	      PERF_IOC_FLAG_GROUP);
+    }
+}
+
+// Stop c's counters, reading their values into c->values
+static void disable_counters(counters_data *c)
+{
+    if (c->fds[counter_cycles] < 0) {
+	return;
+    }
+    ioctl(c->fds[counter_cycles], PERF_EVENT_IOC_DISABLE,
+	  PERF_IOC_FLAG_GROUP);
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+	counter_reading r;
+	if (c->fds[i] < 0
+	    || read(c->fds[i], &r, sizeof(r)) != (ssize_t) sizeof(r)) {
+	    c->values[i] = 0;
+	} else if (r.time_running != 0 && r.time_running < r.time_enabled) {
+	    c->values[i] = (unsigned long long)
+		((double) r.value * r.time_enabled / r.time_running);
+	} else {
+	    c->values[i] = r.value;
+	}
+    }
+}
+#else
+// there are no perf_event counters on other systems
+static void open_counters(counters_data *c)
+{
+    c->open_error = ENOSYS;
+}
+
+static void enable_counters(counters_data *c)
+{
+}
+
+static void disable_counters(counters_data *c)
+{
+}
+#endif
+
+// Return the seconds from start to end
+static double seconds_between(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Open c's counters (the first time), and start them from 0
+void counters_start(counters_data *c)
+{
+    if (c->open_error < 0) {
+	open_counters(c);
+    }
+    c->finished = false;
+    c->running = true;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &c->cpu_start);
+    clock_gettime(CLOCK_MONOTONIC, &c->wall_start);
+    // last, so that as little as possible of the above is counted
+    enable_counters(c);
+}
+
+// Stop c's counters, reading their values
+void counters_stop(counters_data *c)
+{
+    if (!c->running) {
+	return;
+    }
+    // first, so that as little as possible of the below is counted
+    disable_counters(c);
+    struct timespec wall_end, cpu_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_end);
+    c->wall_seconds = seconds_between(c->wall_start, wall_end);
+    c->cpu_seconds = seconds_between(c->cpu_start, cpu_end);
+    c->running = false;
+}
+
+// Print the count of a hardware event on out, with its ratio to the
+// VM's instructions and dispatches (when they are known and not 0)
+static void print_count(FILE *out, const char *name, unsigned long long value,
+			const counters_vm_counts *counts)
+{
+    fprintf(out, "  %-24s %15llu", name, value);
+    if (counts->instructions_known && counts->instructions != 0) {
+	fprintf(out, " %10.2f per VM instruction",
+		(double) value / counts->instructions);
+    }
+    if (counts->dispatches_known && counts->dispatches != 0
+	&& !(counts->instructions_known
+	     && counts->instructions == counts->dispatches)) {
+	fprintf(out, " %10.2f per dispatch",
+		(double) value / counts->dispatches);
+    }
+    fprintf(out, "\n");
+}
+
+// Print one of the VM's counts on out, or say it was not counted
+static void print_vm_count(FILE *out, const char *name, bool known,
+			   unsigned long value)
+{
+    if (known) {
+	fprintf(out, "  %-24s %15lu\n", name, value);
+    } else {
+	fprintf(out, "  %-24s %15s\n", name, "(not counted)");
+    }
+}
+
+// Stop c's counters and write the report on out (only once)
+void counters_report(counters_data *c, FILE *out, bool halted,
+		     const counters_vm_counts *counts)
+{
+    if (c->finished) {
+	return;
+    }
+    counters_stop(c);
+    c->finished = true;
+    fprintf(out, "Counters (%s engine, %s):\n", counts->engine,
+	    halted ? "halted" : "stopped by an error");
+    fprintf(out, "  %-24s %15.3f ms\n", "wall-clock time",
+	    c->wall_seconds * 1000.0);
+    fprintf(out, "  %-24s %15.3f ms\n", "CPU time", c->cpu_seconds * 1000.0);
+    if (c->open_error != 0) {
+	fprintf(out, "  hardware counters are not available (%s)\n",
+		strerror(c->open_error));
+    } else {
+	for (int i = 0; i < NUM_COUNTERS; i++) {
+	    if (c->fds[i] >= 0) {
+		print_count(out, counter_names[i], c->values[i], counts);
+	    } else {
+		fprintf(out, "  %-24s %15s\n", counter_names[i],
+			"(not supported)");
+	    }
+	}
+	if (c->values[counter_cycles] != 0) {
+	    fprintf(out, "  %-24s %15.2f\n", "instructions per cycle",
+		    (double) c->values[counter_instructions]
+		    / c->values[counter_cycles]);
+	}
+    }
+    print_vm_count(out, "VM instructions", counts->instructions_known,
+		   counts->instructions);
+    print_vm_count(out, "dispatches", counts->dispatches_known,
+		   counts->dispatches);
+    print_vm_count(out, "calls and backward jumps", counts->calls_known,
+		   counts->calls);
+    if (counts->instructions_known && counts->instructions != 0) {
+	fprintf(out, "  %-24s %15.2f ns\n", "time per VM instruction",
+		c->wall_seconds * 1e9 / counts->instructions);
+    }
+}
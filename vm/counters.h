@@ -0,0 +1,84 @@
+#ifndef _COUNTERS_H
+#define _COUNTERS_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
+
+// The counters report (vm -P) measures the run of a program (the
+// machine's main loop, in whichever engine it uses) with the processor's
+// hardware counters, through Linux's perf_event interface: the cycles,
+// instructions, branch misses, and level 1 data cache misses of the
+// process in user mode. Where those are not available (on another OS,
+// in a container or VM without a PMU, or if perf_event_paranoid forbids
+// them), only the wall-clock and CPU times (from clock_gettime) are
+// reported. The report (on stderr) also gives what the VM itself counts,
+// so that the hardware's numbers can be divided by them (see
+// counters_report).
+
+// the hardware events counted
+typedef enum {
+    counter_cycles,
+    counter_instructions,
+    counter_branch_misses,
+    counter_l1d_misses,
+    NUM_COUNTERS
+} counter_kind;
+
+// the counters of one VM's run
+typedef struct {
+    // the perf_event file descriptor of each event (-1 if it could not
+    // be opened); the first one opened leads the group, so all of them
+    // count over exactly the same instructions
+    int fds[NUM_COUNTERS];
+    // the errno from opening the cycles counter (0 if it was opened)
+    int open_error;
+    // the counts, and the times (in seconds) from start to stop
+    unsigned long long values[NUM_COUNTERS];
+    double wall_seconds;
+    double cpu_seconds;
+    // the clocks when the counters were started
+    struct timespec wall_start;
+    struct timespec cpu_start;
+    // are the counters counting, and has the report been written?
+    bool running;
+    bool finished;
+} counters_data;
+
+// what the VM counted while the counters ran (see counters_report)
+typedef struct {
+    // the engine that ran the program (its name, as vm -e takes it)
+    const char *engine;
+    // the VM instructions executed, if they were counted
+    bool instructions_known;
+    unsigned long instructions;
+    // the instructions dispatched (fused ones counting once),
+    // if they were counted
+    bool dispatches_known;
+    unsigned long dispatches;
+    // the calls and backward jumps made (the fuel used; see
+    // machine_set_fuel), if the engine kept track of them
+    bool calls_known;
+    unsigned long calls;
+} counters_vm_counts;
+
+// Set up c, not counting (nothing is opened until counters_start)
+extern void counters_create(counters_data *c);
+
+// Close c's counters
+extern void counters_destroy(counters_data *c);
+
+// Open c's counters (the first time), and start them from 0
+extern void counters_start(counters_data *c);
+
+// Stop c's counters (if they are running), reading their values
+extern void counters_stop(counters_data *c);
+
+// Requires: out is open for writing, and counters_start has been
+// called on c
+// Stop c's counters and write the report on out (only once),
+// saying whether the machine halted (otherwise an error stopped it)
+// and giving what the VM counted (and the ratios of the hardware's
+// counts to them)
+extern void counters_report(counters_data *c, FILE *out, bool halted,
+			    const counters_vm_counts *counts);
+#endif
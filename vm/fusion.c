@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "instruction.h"
+#include "fusion.h"
+
+// the mnemonics and sequences of the fused instructions,
+// indexed by op - NUM_OPCODES
+static const char *fused_names[NUM_FUSIONS] = {
+    "LDL", "LDO", "STK", "ADI", "SBI", "JPZ",
+    "BNE", "BEQ", "BGE", "BGT", "BLE", "BLT",
+    "LDD"
+};
+static const char *fused_sequences[NUM_FUSIONS] = {
+    "PBP; LOD", "PBP; PSI...; LOD", "PBP; LIT; STO",
+    "LIT; ADD", "LIT; SUB", "JPC 2; JMP",
+    "EQL; JPC 2; JMP", "NEQ; JPC 2; JMP", "LSS; JPC 2; JMP",
+    "LEQ; JPC 2; JMP", "GTR; JPC 2; JMP", "GEQ; JPC 2; JMP",
+    "PDB; LOD"
+};
+
+// Return the fused branch for the comparison op
+// followed by JPC 2; JMP (which jumps when the comparison is false),
+// or NOP if op is not a comparison
+static int branch_for(int op)
+{
+    switch (op) {
+    case EQL:
+	return BNE;
+    case NEQ:
+	return BEQ;
+    case LSS:
+	return BGE;
+    case LEQ:
+	return BGT;
+    case GTR:
+	return BLE;
+    case GEQ:
+	return BLT;
+    default:
+	return NOP;
+    }
+}
+
+// Requires: code has at least size elements and 0 <= pc < size
+// Rewrite fused[pc] to the fused instruction for the sequence
+// starting at pc in code, if there is one
+static void fuse_at(instruction code[], int size, fused_instr fused[], int pc)
+{
+    // the number of instructions after pc
+    int rest = size - pc - 1;
+    instruction *seq = &code[pc];
+    fused_instr f = { NOP, 0, 0 };
+    switch (seq[0].op) {
+    case PBP:
+	if (rest >= 1 && seq[1].op == LOD) {
+	    f = (fused_instr) { LDL, seq[1].m, 0 };
+	} else if (rest >= 2 && seq[1].op == LIT && seq[2].op == STO) {
+	    f = (fused_instr) { STK, seq[2].m, seq[1].m };
+	} else {
+	    int k = 1;
+	    while (k <= rest && seq[k].op == PSI) {
+		k++;
+	    }
+	    if (k > 1 && k <= rest && seq[k].op == LOD) {
+		f = (fused_instr) { LDO, seq[k].m, k-1 };
+	    }
+	}
+	break;
+    case PDB:
+	if (rest >= 1 && seq[1].op == LOD) {
+	    f = (fused_instr) { LDD, seq[1].m, seq[0].m };
+	}
+	break;
+    case LIT:
+	if (rest >= 1 && seq[1].op == ADD) {
+	    f = (fused_instr) { ADI, seq[0].m, 0 };
+	} else if (rest >= 1 && seq[1].op == SUB) {
+	    f = (fused_instr) { SBI, seq[0].m, 0 };
+	}
+	break;
+    case JPC:
+	if (seq[0].m == 2 && rest >= 1 && seq[1].op == JMP) {
+	    // the JMP's target, relative to pc
+	    f = (fused_instr) { JPZ, 1 + seq[1].m, 0 };
+	}
+	break;
+    default:
+	if (branch_for(seq[0].op) != NOP && rest >= 2
+	    && seq[1].op == JPC && seq[1].m == 2 && seq[2].op == JMP) {
+	    f = (fused_instr) { branch_for(seq[0].op), 2 + seq[2].m, 0 };
+	}
+	break;
+    }
+    if (f.op != NOP) {
+	fused[pc] = f;
+    }
+}
+
+// Requires: code and fused have at least size elements
+// Copy the program in code into fused, fusing instructions
+// if fuse is true.
+void fuse_program(instruction code[], int size, fused_instr fused[],
+		  bool fuse)
+{
+    for (int pc = 0; pc < size; pc++) {
+	fused[pc] = (fused_instr) { code[pc].op, code[pc].m, 0 };
+    }
+    if (!fuse) {
+	return;
+    }
+    // each address is considered on its own, so a sequence
+    // can start inside another (e.g., at the JPC of a fused branch)
+    for (int pc = 0; pc < size; pc++) {
+	fuse_at(code, size, fused, pc);
+    }
+}
+
+// Requires: out is open for writing
+// Print on out the number of sites and executions of each fused instruction
+void fusion_print_stats(FILE *out, fused_instr fused[], int size,
+			unsigned long hits[])
+{
+    int sites[NUM_FUSIONS] = { 0 };
+    for (int pc = 0; pc < size; pc++) {
+	if (fused[pc].op >= NUM_OPCODES) {
+	    sites[fused[pc].op - NUM_OPCODES]++;
+	}
+    }
+    fprintf(out, "Fused instructions:\n");
+    fprintf(out, "%-4s %-17s %6s %12s\n", "Op", "Sequence", "Sites",
+	    "Executions");
+    for (int i = 0; i < NUM_FUSIONS; i++) {
+	fprintf(out, "%-4s %-17s %6d %12lu\n", fused_names[i],
+		fused_sequences[i], sites[i], hits[i]);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef _FUSION_H
+#define _FUSION_H
+#include <stdio.h>
+#include <stdbool.h>
+#include "instruction.h"
+
+// the internal op codes of fused instructions, numbered after
+// the machine's op codes; each replaces the first instruction
+// of a short sequence and does the work of the whole sequence
+typedef enum {
+    LDL = NUM_OPCODES, // PBP; LOD m
+    LDO, // PBP; PSI (n times); LOD m
+    STK, // PBP; LIT n; STO m
+    ADI, // LIT m; ADD
+    SBI, // LIT m; SUB
+    JPZ, // JPC 2; JMP m-1
+    BNE, // EQL; JPC 2; JMP m-2
+    BEQ, // NEQ; JPC 2; JMP m-2
+    BGE, // LSS; JPC 2; JMP m-2
+    BGT, // LEQ; JPC 2; JMP m-2
+    BLE, // GTR; JPC 2; JMP m-2
+    BLT, // GEQ; JPC 2; JMP m-2
+    LDD  // PDB n; LOD m
+} fused_opcode;
+
+// one more than the highest internal op code
+#define NUM_FUSED_OPCODES (LDD+1)
+
+// the number of kinds of fused instructions
+#define NUM_FUSIONS (NUM_FUSED_OPCODES - NUM_OPCODES)
+
+// an instruction after fusion, with a second operand
+// for the fused instructions that need one
+typedef struct {
+    int op; /* opcode (possibly a fused_opcode) */
+    int m; /* M */
+    int n; /* second operand (0 if not used) */
+} fused_instr;
+
+// Requires: code and fused have at least size elements
+// Copy the program in code (which has size instructions) into fused,
+// replacing the first instruction of each sequence listed above
+// with its fused instruction, if fuse is true.
+// The other instructions are left where they were, so addresses
+// do not change and jumps into the middle of a sequence still work;
+// the fused instruction continues after the last instruction
+// of its sequence, as the sequence would.
+extern void fuse_program(instruction code[], int size, fused_instr fused[],
+			 bool fuse);
+
+// Requires: out is open for writing, fused has size elements,
+//           and hits has NUM_FUSIONS elements
+// Print on out how many sites each kind of fused instruction
+// was used for in fused, and how many times it was executed
+// (given by hits, indexed by op - NUM_OPCODES).
+extern void fusion_print_stats(FILE *out, fused_instr fused[], int size,
+			       unsigned long hits[]);
+#endif
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "utilities.h"
+#include "char_io.h"
+#include "input_log.h"
+
+// Set up log, neither recording nor replaying
+void input_log_create(input_log *log)
+{
+    log->record_filename = NULL;
+    log->replay_filename = NULL;
+    memset(&log->header, 0, sizeof(log->header));
+    log->chars = NULL;
+    log->map = NULL;
+    log->map_size = 0;
+    log->next = 0;
+    log->finished = false;
+}
+
+// Give back log's space
+void input_log_destroy(input_log *log)
+{
+    if (log->map != NULL) {
+	munmap(log->map, log->map_size);
+	log->map = NULL;
+	log->chars = NULL;
+    }
+}
+
+// Record the input read with io in the file named filename
+void input_log_record(input_log *log, char_io *io, const char *filename)
+{
+    log->record_filename = filename;
+    char_io_record(io);
+}
+
+// The read hook while replaying: read from the log's characters
+// and then, as the recorded run did, from the end of the input
+static ssize_t read_log(void *arg, char *buf, size_t size)
+{
+    input_log *log = (input_log *) arg;
+    size_t n = log->header.length - log->next;
+    if (n == 0 && !log->header.ended) {
+	bail_with_error("The program read past the input recorded in '%s'",
+			log->replay_filename);
+    }
+    if (n > size) {
+	n = size;
+    }
+    memcpy(buf, log->chars + log->next, n);
+    log->next += n;
+    return n;
+}
+
+// Make io read the input recorded in the file named filename
+void input_log_replay(input_log *log, char_io *io, const char *filename)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	bail_with_error("Cannot open file '%s'", filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+	bail_with_error("Cannot read file '%s'", filename);
+    }
+    size_t size = st.st_size;
+    if (size < sizeof(input_log_header)) {
+	errno = 0;
+	bail_with_error("The file '%s' is not an input log", filename);
+    }
+    void *mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+	bail_with_error("Cannot map the input log '%s'", filename);
+    }
+    memcpy(&log->header, mem, sizeof(log->header));
+    if (memcmp(log->header.magic, INPUT_LOG_MAGIC,
+	       sizeof(log->header.magic)) != 0
+	|| log->header.length > size - sizeof(input_log_header)) {
+	bail_with_error("The file '%s' is not an input log", filename);
+    }
+    log->replay_filename = filename;
+    log->map = mem;
+    log->map_size = size;
+    log->chars = (const char *) mem + sizeof(input_log_header);
+    log->next = 0;
+    char_io_set_read_hook(io, read_log, log);
+}
+
+// Write the input recorded by io to the log file,
+// with the number of instructions executed, if counted
+static void write_log(input_log *log, char_io *io, bool counted,
+		      unsigned long instructions)
+{
+    input_log_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic));
+    size_t len;
+    bool ended;
+    const char *chars = char_io_recorded(io, &len, &ended);
+    header.ended = ended;
+    header.counted = counted;
+    header.instructions = counted ? instructions : 0;
+    header.length = len;
+    FILE *out = fopen(log->record_filename, "wb");
+    if (out == NULL) {
+	perror(log->record_filename);
+	return;
+    }
+    if (fwrite(&header, sizeof(header), 1, out) != 1
+	|| (len > 0 && fwrite(chars, 1, len, out) != len)) {
+	perror(log->record_filename);
+    }
+    if (fclose(out) == EOF) {
+	perror(log->record_filename);
+    }
+}
+
+// Finish the run (only once)
+void input_log_finish(input_log *log, char_io *io, bool halted,
+		      bool counted, unsigned long instructions)
+{
+    if (log->finished) {
+	return;
+    }
+    log->finished = true;
+    if (log->record_filename != NULL) {
+	write_log(log, io, counted, instructions);
+    }
+    if (halted && log->replay_filename != NULL && counted
+	&& log->header.counted && log->header.instructions != instructions) {
+	errno = 0;
+	bail_with_error("The replayed run executed %lu instructions,"
+			" but the run recorded in '%s' executed %lu",
+			instructions, log->replay_filename,
+			(unsigned long) log->header.instructions);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef _INPUT_LOG_H
+#define _INPUT_LOG_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "char_io.h"
+
+// Input logs (vm -w log-file and vm -i log-file) make a run
+// reproducible: recording (-w) writes every character the program's
+// CHI instructions read, and whether they read to the end of the input,
+// to a log file; replaying (-i) feeds CHI from such a log instead of
+// the standard input, so the run can be done again, as often as needed
+// (to measure it, or with another engine), without a terminal or a pipe.
+// A run that read to the end of its input gets EOF at the same place
+// when replayed; a replayed run that reads past the characters
+// of a run that did not is stopped with an error, as it has gone
+// somewhere the recorded run did not.
+// If the recorded run counted its instructions (see machine_counted),
+// the log has their number, and a replayed run that counts them
+// is checked to execute just as many.
+//
+// A log file is a header (input_log_header) followed by the characters,
+// as they were read. Its integers are in the byte order of the machine
+// that wrote it.
+
+// the first bytes of a log file
+#define INPUT_LOG_MAGIC "PL0INPUT"
+
+// the start of a log file
+typedef struct {
+    char magic[8];          // INPUT_LOG_MAGIC (without the null character)
+    uint32_t ended;         // 1 if the run's CHI instructions read EOF
+    uint32_t counted;       // 1 if instructions is known
+    uint64_t instructions;  // the number of instructions the run executed
+    uint64_t length;        // the number of characters that follow
+} input_log_header;
+
+// the input log of one VM's run
+typedef struct {
+    // the file to record the input in (or NULL, if not recording)
+    const char *record_filename;
+    // the file the input is replayed from (or NULL, if not replaying),
+    // its header, its characters (mapped into memory, with the size
+    // of the mapping), and the next character to be read
+    const char *replay_filename;
+    input_log_header header;
+    const char *chars;
+    void *map;
+    size_t map_size;
+    size_t next;
+    // has the log been finished?
+    bool finished;
+} input_log;
+
+// Set up log, neither recording nor replaying
+extern void input_log_create(input_log *log);
+
+// Give back (or unmap) log's space
+extern void input_log_destroy(input_log *log);
+
+// Requires: char_io_initialize has not been called on io
+// Record the input read with io in the file named filename
+// (when the log is finished)
+extern void input_log_record(input_log *log, char_io *io,
+			     const char *filename);
+
+// Requires: char_io_initialize has not been called on io
+// Make io read the input recorded in the log file named filename,
+// bailing with an error if it cannot be read or is not a log file
+extern void input_log_replay(input_log *log, char_io *io,
+			     const char *filename);
+
+// Finish the run (only once): write the log file, if recording,
+// with the number of instructions executed if counted is true;
+// if halted (the machine halted, so this may report an error),
+// replaying, and both this run and the recorded one counted
+// their instructions, bail with an error if they differ
+extern void input_log_finish(input_log *log, char_io *io, bool halted,
+			     bool counted, unsigned long instructions);
+#endif
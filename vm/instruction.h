@@ -1,41 +1,100 @@
-/* $Id: instruction.h,v 1.7 2023/03/20 17:13:53 leavens Exp $ */
-#ifndef _INSTRUCTION_H
-#define _INSTRUCTION_H
-#include <stdio.h>
-#include <stdbool.h>
-
-typedef struct {
-    int op; /* opcode */
-    int m; /* M */
-} instruction;
-
-extern bool stop_reading;
-extern instruction read_instruction(FILE *);
-
-// Is the argument a legal op code for the machine?
-extern bool legal_op_code(int op);
-
-// Requires: legal_op_code(op);
-// Return the ASCII mnemonic for the op code given.
-extern const char * mnemonic(int op);
-
-// Requires: out is open and writable
-// print the header of the output table to out
-extern void print_instruction_heading(FILE *out);
-
-// Requires: out is an open FILE
-// print the instruction with mnemonic (on one line)
-// followed by a newline character.
-void print_instr_debug(FILE *out, instruction instr);
-
-// Requires: out is an open FILE
-// print the address on out followed by the instruction (on one line)
-// followed by a newline character.
-void print_instr_with_addr(FILE *out, int addr, instruction instr);
-
-// Requires: out is an open FILE
-// print the instruction in the VM's input format,
-// followed by a newline character.
-void print_vm_instruction(FILE *out, instruction instr);
-
-#endif
+/* $Id: instruction.h,v 1.7 2023/03/20 17:13:53 leavens Exp $ */
+#ifndef _INSTRUCTION_H
+#define _INSTRUCTION_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// one more than the highest op code, to allow for 0
+#define NUM_OPCODES 36
+
+// the machine's op codes, in numeric order;
+// PDB, SDB, and RDB use the display (see DISPLAY_SIZE):
+// PDB m pushes the display's entry for level m,
+// SDB m saves the entry for level m at BP (in the static link's place)
+// and sets the entry to BP, and RDB m restores it from BP;
+// CNL and RNL call and return as CAL and RTN do, but with frames
+// that have no static link (see LINKS_SIZE_NO_STAT_LNK)
+typedef enum {
+     NOP, LIT, RTN, CAL, POP, PSI, LOD, STO, INC, JMP,
+     JPC, CHO, CHI, HLT, NDB, NEG, ADD, SUB, MUL, DIV,
+     MOD, EQL, NEQ, LSS, LEQ, GTR, GEQ, PSP, PBP, PPC,
+     JMI, PDB, SDB, RDB, CNL, RNL
+} opcode;
+
+typedef struct {
+    int op; /* opcode */
+    int m; /* M */
+} instruction;
+
+// The code the machine runs is kept packed, one 32-bit word
+// per instruction: its opcode in the low PACKED_OP_BITS bits,
+// and its M, a signed number, in the rest. An instruction that does
+// not fit (with an M out of range, or an opcode that is not legal)
+// is escaped: the opcode bits are PACKED_ESCAPE and the rest
+// is an index into the program's table of escaped instructions,
+// which has each of them whole.
+// The instruction struct is what is read, printed, and checked.
+typedef uint32_t packed_instr;
+
+#define PACKED_OP_BITS 6
+#define PACKED_ESCAPE ((1 << PACKED_OP_BITS) - 1)
+#define PACKED_M_MIN (-(1 << (31 - PACKED_OP_BITS)))
+#define PACKED_M_MAX ((1 << (31 - PACKED_OP_BITS)) - 1)
+
+// the opcode (or PACKED_ESCAPE) and M (or escape index) of w
+#define PACKED_OP(w) ((int) ((w) & PACKED_ESCAPE))
+#define PACKED_M(w) ((int) ((int32_t) (w) >> PACKED_OP_BITS))
+
+// Requires: code and packed have at least size elements
+// Pack the program in code (which has size instructions) into packed,
+// setting *escapes to a new array (allocated with malloc, NULL if
+// none are needed) of the instructions that must be escaped;
+// return false (having given back *escapes) if there is not enough
+// space
+extern bool pack_program(instruction code[], int size, packed_instr packed[],
+			 instruction **escapes);
+
+// Requires: escapes is the table made when packed was packed
+// Return the instruction packed in w
+static inline instruction unpack_instr(packed_instr w, instruction escapes[])
+{
+    if (PACKED_OP(w) == PACKED_ESCAPE) {
+	return escapes[PACKED_M(w)];
+    }
+    instruction instr = { PACKED_OP(w), PACKED_M(w) };
+    return instr;
+}
+
+// Requires: in is open for reading
+// Read an instruction (all on one line) from in and return it,
+// setting *stop_reading to true if there is an error or EOF
+extern instruction read_instruction(FILE *in, bool *stop_reading);
+
+// Is the argument a legal op code for the machine?
+extern bool legal_op_code(int op);
+
+// Requires: legal_op_code(op);
+// Return the ASCII mnemonic for the op code given.
+extern const char * mnemonic(int op);
+
+// Requires: out is open and writable
+// print the header of the output table to out
+extern void print_instruction_heading(FILE *out);
+
+// Requires: out is an open FILE
+// print the instruction with mnemonic (on one line)
+// followed by a newline character.
+void print_instr_debug(FILE *out, instruction instr);
+
+// Requires: out is an open FILE
+// print the address on out followed by the instruction (on one line)
+// followed by a newline character.
+void print_instr_with_addr(FILE *out, int addr, instruction instr);
+
+// Requires: out is an open FILE
+// print the instruction in the VM's input format,
+// followed by a newline character.
+void print_vm_instruction(FILE *out, instruction instr);
+
+#endif
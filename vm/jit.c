@@ -0,0 +1,715 @@
+// for MAP_ANONYMOUS
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <errno.h>
+#include "machine_types.h"
+#include "instruction.h"
+#include "utilities.h"
+#include "stack.h"
+#include "char_io.h"
+#include "verifier.h"
+#include "machine.h"
+#include "jit.h"
+
+// The JIT generates x86-64 code for the System V calling convention.
+// Define NO_JIT to leave it out.
+#if defined(__x86_64__) && defined(__unix__) && !defined(NO_JIT)
+#define HAVE_JIT
+#endif
+
+#ifndef HAVE_JIT
+
+// Is there a JIT for this machine?
+bool jit_available()
+{
+    return false;
+}
+
+// There is no JIT, so run nothing
+bool jit_run(vm_t *vm)
+{
+    return false;
+}
+
+// There is never a compiled program to free
+void jit_free(struct jit_program *prog)
+{
+}
+
+#else // HAVE_JIT
+
+#include <sys/mman.h>
+
+// How the generated code works:
+// Only verified programs are translated, so the height of the stack
+// (SP - BP) before each instruction is known when it is translated
+// (see verifier.h); each push and pop is then a store or load
+// at a fixed offset from the frame's base, and SP is only computed
+// when it is needed (by PSP, CAL, HLT, and when leaving the code).
+// The registers used are
+//    rbp: the jit_state passed to the generated code
+//    rbx: the verifier's results (info), for the checks in RTN
+//    r12: the stack's storage
+//    r13: BP
+//    r14: the address of the stack's storage at BP
+//    r15: the table of native addresses of instructions
+// (all saved by C functions, so they survive calls to helpers),
+// while rax, rcx, rdx, rdi, and r11 are scratch registers.
+// JMP and JPC become native jumps, CAL (and CNL) checks that the callee's
+// frame fits (as the threaded engine's unchecked mode does) and jumps
+// to the callee, and RTN (and RNL) checks the caller's frame and jumps
+// through the table; if a check fails, the generated code returns
+// so that a checked interpreter can continue.
+// When the VM's fuel is limited (see machine_set_fuel), each call
+// and backward jump also uses up a unit of the fuel in the jit_state,
+// returning to let the interpreter report it when there is none left.
+
+// the state passed between jit_run and the generated code
+typedef struct {
+    word *stk;                  // the stack's storage
+    verified_instr *info;       // the verifier's results
+    const uint8_t **table;      // native address of each instruction
+    char_io *io;                // the VM's character I/O, for CHO and CHI
+    address *display;           // the VM's display, for PDB, SDB, and RDB
+    int pc;                     // PC, on entry and exit
+    int sp;                     // SP, on exit
+    int bp;                     // BP, on entry and exit
+    unsigned long fuel;         // the VM's fuel, on entry and exit
+} jit_state;
+
+// a program compiled by the JIT, kept (in its VM) for later runs
+struct jit_program {
+    uint8_t *code;              // the generated code (code_size bytes)
+    size_t code_size;
+    const uint8_t **table;      // native address of each instruction
+    int max_height;             // the maximum height it was compiled for
+    bool fueled;                // was it compiled to use fuel?
+};
+
+// the generated code's status when it returns
+#define JIT_HALTED 0
+#define JIT_FALLBACK 1
+
+// the RTN check indexes the info array with a scale of 8
+_Static_assert(sizeof(verified_instr) == 8,
+	       "verified_instr must be two ints");
+
+// x86-64 register numbers
+enum { RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6,
+       RDI = 7, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15 };
+
+// x86-64 condition codes (for jcc and setcc)
+enum { CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_L = 0xC,
+       CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF };
+
+// The state of the code generator is kept for each thread,
+// as each thread can compile a program for its own VM.
+
+// the buffer the code is generated into
+static _Thread_local uint8_t *buf;
+static _Thread_local size_t buf_len;
+static _Thread_local size_t buf_cap;
+
+// a jump whose 32-bit displacement (at offset at in buf)
+// is filled in when the code is all generated
+typedef struct {
+    size_t at;
+    bool to_stub; // to the fallback stub of pc (otherwise to pc's code)
+    int pc;
+} fixup;
+
+static _Thread_local fixup *fixups;
+static _Thread_local int num_fixups;
+
+// offsets in buf of the code for each instruction,
+// and of each instruction's fallback stub (or 0 if it has none)
+static _Thread_local size_t *native_off;
+static _Thread_local size_t *stub_off;
+
+// offset in buf of the code that returns to jit_run
+static _Thread_local size_t epilogue_off;
+
+// the maximum height of the stack the code is generated for
+static _Thread_local int max_height;
+// does the code use fuel at calls and backward jumps?
+static _Thread_local bool fueled;
+
+// Emit the byte b
+static void emit(int b)
+{
+    if (buf_len >= buf_cap) {
+	bail_with_error("JIT code buffer overflow!");
+    }
+    buf[buf_len++] = (uint8_t) b;
+}
+
+// Emit n (of size bytes) in little-endian order
+static void emit_n(uint64_t n, int size)
+{
+    for (int i = 0; i < size; i++) {
+	emit((n >> (8*i)) & 0xff);
+    }
+}
+
+// Emit the prefixes and opcode (of oplen bytes, most significant first)
+// of an instruction whose operands are register reg and, in the ModRM
+// byte, rm (and index); op16 selects a 16-bit operation and w a 64-bit one
+static void emit_opcode(bool op16, bool w, uint32_t opcode, int oplen,
+			int reg, int index, int rm)
+{
+    if (op16) {
+	emit(0x66);
+    }
+    int rex = (w ? 8 : 0) | ((reg & 8) ? 4 : 0)
+	| ((index >= 0 && (index & 8)) ? 2 : 0) | ((rm & 8) ? 1 : 0);
+    if (rex != 0) {
+	emit(0x40 | rex);
+    }
+    for (int i = oplen - 1; i >= 0; i--) {
+	emit((opcode >> (8*i)) & 0xff);
+    }
+}
+
+// Emit an instruction with register (or /digit) reg
+// and the memory operand [base + index*scale + disp] (index < 0 for none)
+static void op_mem(bool op16, bool w, uint32_t opcode, int oplen,
+		   int reg, int base, int index, int scale, int32_t disp)
+{
+    emit_opcode(op16, w, opcode, oplen, reg, index, base);
+    if (index < 0 && (base & 7) != RSP) {
+	emit(0x80 | ((reg & 7) << 3) | (base & 7));
+    } else {
+	int ss = (scale == 1) ? 0 : (scale == 2) ? 1 : (scale == 4) ? 2 : 3;
+	emit(0x80 | ((reg & 7) << 3) | RSP);
+	emit((ss << 6) | (((index < 0) ? RSP : index) & 7) << 3 | (base & 7));
+    }
+    emit_n((uint32_t) disp, 4);
+}
+
+// Emit an instruction with register (or /digit) reg and register rm
+static void op_rr(bool op16, bool w, uint32_t opcode, int oplen,
+		  int reg, int rm)
+{
+    emit_opcode(op16, w, opcode, oplen, reg, -1, rm);
+    emit(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// the offset from r14 of the stack slot at height h in the current frame
+#define SLOT(h) (2 * (h))
+
+// Emit movsx reg, word [r14 + SLOT(h)]
+static void load_slot(int reg, int h)
+{
+    op_mem(false, false, 0x0FBF, 2, reg, R14, -1, 1, SLOT(h));
+}
+
+// Emit mov word [r14 + SLOT(h)], reg
+static void store_slot(int reg, int h)
+{
+    op_mem(true, false, 0x89, 1, reg, R14, -1, 1, SLOT(h));
+}
+
+// Emit mov word [r14 + SLOT(h)], val
+static void store_slot_imm(int h, word val)
+{
+    op_mem(true, false, 0xC7, 1, 0, R14, -1, 1, SLOT(h));
+    emit_n((uint16_t) val, 2);
+}
+
+// Emit a call of the C function f (whose arguments are already
+// in their registers)
+static void call_helper(void *f)
+{
+    // mov r11, f; call r11
+    emit(0x49);
+    emit(0xBB);
+    emit_n((uint64_t) (uintptr_t) f, 8);
+    emit(0x41);
+    emit(0xFF);
+    emit(0xD3);
+}
+
+// Emit a jump (opcode, of oplen bytes) with a 32-bit displacement
+// to the code for pc (or to its fallback stub, if to_stub)
+static void jump_to(uint32_t opcode, int oplen, bool to_stub, int pc)
+{
+    for (int i = oplen - 1; i >= 0; i--) {
+	emit((opcode >> (8*i)) & 0xff);
+    }
+    fixups[num_fixups].at = buf_len;
+    fixups[num_fixups].to_stub = to_stub;
+    fixups[num_fixups].pc = pc;
+    num_fixups++;
+    if (to_stub) {
+	stub_off[pc] = 1; // needed (the real offset is set later)
+    }
+    emit_n(0, 4);
+}
+
+// Emit a jump to the epilogue (which is before all other jumps' sources)
+static void jump_to_epilogue()
+{
+    emit(0xE9);
+    emit_n((uint32_t) (epilogue_off - (buf_len + 4)), 4);
+}
+
+// the helpers called to report errors, which do not return
+
+static void jit_illegal_fetch(int addr)
+{
+    bail_with_error("Illegal stack index in stack_fetch: %d", addr);
+}
+
+static void jit_illegal_assign(int addr)
+{
+    bail_with_error("Illegal stack index in stack_assign: %d", addr);
+}
+
+static void jit_divide_by_zero()
+{
+    bail_with_error("Divisor is zero in DIV instruction!");
+}
+
+static void jit_modulus_by_zero()
+{
+    bail_with_error("Modulus is zero in MOD instruction!");
+}
+
+// Emit a check that the address in eax is a legal stack index,
+// calling helper (with the address) if not
+static void check_index(void *helper)
+{
+    if (max_height >= STACK_CAPACITY) {
+	return; // every address is legal
+    }
+    // cmp eax, max_height; jb ok; mov edi, eax; call helper; ok:
+    op_rr(false, false, 0x81, 1, 7, RAX);
+    emit_n(max_height, 4);
+    emit(0x70 | CC_B);
+    emit(15);
+    op_rr(false, false, 0x89, 1, RAX, RDI);
+    call_helper(helper);
+}
+
+// Emit the code that leaves the generated code at pc (whose stack
+// height is h) with the given status, setting the state's PC to new_pc
+static void emit_exit(int new_pc, int h, int status)
+{
+    // mov dword [rbp + pc], new_pc
+    op_mem(false, false, 0xC7, 1, 0, RBP, -1, 1, offsetof(jit_state, pc));
+    emit_n((uint32_t) new_pc, 4);
+    // lea eax, [r13 + h]; mov [rbp + sp], eax
+    op_mem(false, false, 0x8D, 1, RAX, R13, -1, 1, h);
+    op_mem(false, false, 0x89, 1, RAX, RBP, -1, 1, offsetof(jit_state, sp));
+    // mov eax, status
+    emit(0xB8);
+    emit_n(status, 4);
+    jump_to_epilogue();
+}
+
+// Emit the code that uses up a unit of fuel for the call or backward
+// jump at pc (if the code uses fuel), falling back if there is none
+static void use_fuel(int pc)
+{
+    if (!fueled) {
+	return;
+    }
+    // cmp qword [rbp + fuel], 0; je stub; dec qword [rbp + fuel]
+    op_mem(false, true, 0x83, 1, 7, RBP, -1, 1, offsetof(jit_state, fuel));
+    emit(0);
+    jump_to(0x0F80 | CC_E, 2, true, pc);
+    op_mem(false, true, 0xFF, 1, 1, RBP, -1, 1, offsetof(jit_state, fuel));
+}
+
+// Emit the code for instruction instr at address pc, which is executed
+// with stack height h, in a program with size instructions
+static void translate(instruction instr, int pc, int h, int size,
+		      verified_instr info[])
+{
+    switch (instr.op) {
+    case NOP: case NDB: case POP: case INC:
+	// tracing is already off, and the height is known statically
+	break;
+    case LIT:
+	store_slot_imm(h, instr.m);
+	break;
+    case RTN: case RNL:
+	// ret_addr in eax, old BP in ecx, and old SP - old BP in edx
+	load_slot(RAX, h-1);
+	op_rr(false, false, 0x81, 1, 7, RAX);
+	emit_n(size, 4);
+	jump_to(0x0F80 | CC_AE, 2, true, pc);
+	op_mem(false, false, 0x0FB7, 2, RCX, R14, -1, 1, SLOT(h-2));
+	op_mem(false, false, 0x8D, 1, RDX, R13, -1, 1,
+	       h - ((instr.op == RTN) ? LINKS_SIZE : LINKS_SIZE_NO_STAT_LNK));
+	op_rr(false, false, 0x2B, 1, RDX, RCX);
+	jump_to(0x0F80 | CC_L, 2, true, pc);
+	// the height recorded for the return address
+	op_mem(false, false, 0x3B, 1, RDX, RBX, RAX, 8, 0);
+	jump_to(0x0F80 | CC_NE, 2, true, pc);
+	// old BP + the frame size recorded for the return address
+	op_mem(false, false, 0x8B, 1, RDX, RBX, RAX, 8, 4);
+	op_rr(false, false, 0x03, 1, RDX, RCX);
+	op_rr(false, false, 0x81, 1, 7, RDX);
+	emit_n(max_height, 4);
+	jump_to(0x0F80 | CC_GE, 2, true, pc);
+	// mov r13d, ecx; lea r14, [r12 + rcx*2]; jmp [r15 + rax*8]
+	op_rr(false, false, 0x8B, 1, R13, RCX);
+	op_mem(false, true, 0x8D, 1, R14, R12, RCX, 2, 0);
+	op_mem(false, false, 0xFF, 1, 4, R15, RAX, 8, 0);
+	break;
+    case CAL: case CNL:
+	// fall back unless BP + h + the callee's frame size < max_height
+	op_rr(false, false, 0x81, 1, 7, R13);
+	emit_n(max_height - h - info[instr.m].frame_size, 4);
+	jump_to(0x0F80 | CC_GE, 2, true, pc);
+	use_fuel(pc);
+	if (instr.op == CAL) {
+	    // static link, dynamic link, and return address
+	    load_slot(RAX, 0);
+	    store_slot(RAX, h);
+	    store_slot(R13, h+1);
+	    store_slot_imm(h+2, pc+1);
+	} else {
+	    // dynamic link and return address
+	    store_slot(R13, h);
+	    store_slot_imm(h+1, pc+1);
+	}
+	// the new BP is the old SP
+	op_rr(false, false, 0x81, 1, 0, R13);
+	emit_n(h, 4);
+	op_mem(false, true, 0x8D, 1, R14, R14, -1, 1, SLOT(h));
+	jump_to(0xE9, 1, false, instr.m);
+	break;
+    case PSI: case LOD:
+	if (instr.op == PSI) {
+	    op_mem(false, false, 0x0FB7, 2, RAX, R14, -1, 1, SLOT(h-1));
+	} else {
+	    // the address is (pop() + m), converted to an address
+	    load_slot(RAX, h-1);
+	    op_rr(false, false, 0x81, 1, 0, RAX);
+	    emit_n((uint32_t) instr.m, 4);
+	    op_rr(false, false, 0x0FB7, 2, RAX, RAX);
+	}
+	check_index((void *) jit_illegal_fetch);
+	op_mem(false, false, 0x0FB7, 2, RCX, R12, RAX, 2, 0);
+	store_slot(RCX, h-1);
+	break;
+    case STO:
+	load_slot(RAX, h-2);
+	op_rr(false, false, 0x81, 1, 0, RAX);
+	emit_n((uint32_t) instr.m, 4);
+	op_rr(false, false, 0x0FB7, 2, RAX, RAX);
+	check_index((void *) jit_illegal_assign);
+	load_slot(RCX, h-1);
+	op_mem(true, false, 0x89, 1, RCX, R12, RAX, 2, 0);
+	break;
+    case JMP:
+	if (instr.m <= 0) {
+	    use_fuel(pc);
+	}
+	jump_to(0xE9, 1, false, pc + instr.m);
+	break;
+    case JPC:
+	// cmp word [r14 + SLOT(h-1)], 0
+	op_mem(true, false, 0x83, 1, 7, R14, -1, 1, SLOT(h-1));
+	emit(0);
+	if (fueled && instr.m <= 0) {
+	    // je past; (use fuel); jmp target; past:
+	    emit(0x70 | CC_E);
+	    size_t past = buf_len;
+	    emit(0);
+	    use_fuel(pc);
+	    jump_to(0xE9, 1, false, pc + instr.m);
+	    buf[past] = buf_len - (past + 1);
+	} else {
+	    // jne target
+	    jump_to(0x0F80 | CC_NE, 2, false, pc + instr.m);
+	}
+	break;
+    case CHO:
+	// mov rdi, [rbp + io]
+	op_mem(false, true, 0x8B, 1, RDI, RBP, -1, 1, offsetof(jit_state, io));
+	load_slot(RSI, h-1);
+	call_helper((void *) char_io_put);
+	break;
+    case CHI:
+	op_mem(false, true, 0x8B, 1, RDI, RBP, -1, 1, offsetof(jit_state, io));
+	call_helper((void *) char_io_get);
+	store_slot(RAX, h);
+	break;
+    case HLT:
+	emit_exit(pc+1, h, JIT_HALTED);
+	break;
+    case NEG:
+	op_mem(true, false, 0xF7, 1, 3, R14, -1, 1, SLOT(h-1));
+	break;
+    case ADD: case SUB: case MUL:
+	// the low 16 bits of the result do not depend
+	// on how the operands are extended
+	load_slot(RAX, h-2);
+	load_slot(RCX, h-1);
+	if (instr.op == ADD) {
+	    op_rr(false, false, 0x03, 1, RAX, RCX);
+	} else if (instr.op == SUB) {
+	    op_rr(false, false, 0x2B, 1, RAX, RCX);
+	} else {
+	    op_rr(false, false, 0x0FAF, 2, RAX, RCX);
+	}
+	store_slot(RAX, h-2);
+	break;
+    case DIV: case MOD:
+	load_slot(RAX, h-2);
+	load_slot(RCX, h-1);
+	// test ecx, ecx; jnz ok; call helper; ok:
+	op_rr(false, false, 0x85, 1, RCX, RCX);
+	emit(0x70 | CC_NE);
+	emit(13);
+	call_helper((instr.op == DIV) ? (void *) jit_divide_by_zero
+		    : (void *) jit_modulus_by_zero);
+	// cdq; idiv ecx
+	emit(0x99);
+	op_rr(false, false, 0xF7, 1, 7, RCX);
+	store_slot((instr.op == DIV) ? RAX : RDX, h-2);
+	break;
+    case EQL: case NEQ: case LSS: case LEQ: case GTR: case GEQ:
+	{
+	    int cc = (instr.op == EQL) ? CC_E : (instr.op == NEQ) ? CC_NE
+		: (instr.op == LSS) ? CC_L : (instr.op == LEQ) ? CC_LE
+		: (instr.op == GTR) ? CC_G : CC_GE;
+	    load_slot(RAX, h-2);
+	    load_slot(RCX, h-1);
+	    // cmp eax, ecx; setcc al; movzx eax, al
+	    op_rr(false, false, 0x39, 1, RCX, RAX);
+	    op_rr(false, false, 0x0F90 | cc, 2, 0, RAX);
+	    op_rr(false, false, 0x0FB6, 2, RAX, RAX);
+	    store_slot(RAX, h-2);
+	}
+	break;
+    case PSP:
+	op_mem(false, false, 0x8D, 1, RAX, R13, -1, 1, h);
+	store_slot(RAX, h);
+	break;
+    case PBP:
+	store_slot(R13, h);
+	break;
+    case PPC:
+	store_slot_imm(h, pc+1);
+	break;
+    case PDB: case SDB: case RDB:
+	// the verifier checked m, and that the word at BP is in the frame;
+	// mov rax, [rbp + display]
+	op_mem(false, true, 0x8B, 1, RAX, RBP, -1, 1,
+	       offsetof(jit_state, display));
+	if (instr.op == PDB) {
+	    op_mem(false, false, 0x0FB7, 2, RCX, RAX, -1, 1, 2 * instr.m);
+	    store_slot(RCX, h);
+	} else if (instr.op == SDB) {
+	    op_mem(false, false, 0x0FB7, 2, RCX, RAX, -1, 1, 2 * instr.m);
+	    store_slot(RCX, 0);
+	    op_mem(true, false, 0x89, 1, R13, RAX, -1, 1, 2 * instr.m);
+	} else {
+	    op_mem(false, false, 0x0FB7, 2, RCX, R14, -1, 1, SLOT(0));
+	    op_mem(true, false, 0x89, 1, RCX, RAX, -1, 1, 2 * instr.m);
+	}
+	break;
+    default:
+	// JMI cannot be in a verified program
+	bail_with_error("Undefined opcode in the JIT: %d", instr.op);
+	break;
+    }
+}
+
+// Emit the code that is called from C: it saves the registers
+// the C caller expects to be kept, loads the machine's registers
+// from the jit_state in rdi, and jumps to the code for its PC;
+// then emit the epilogue, which saves BP and returns eax
+static void emit_prologue_and_epilogue()
+{
+    emit(0x53); // push rbx
+    emit(0x55); // push rbp
+    emit(0x41); emit(0x54); // push r12
+    emit(0x41); emit(0x55); // push r13
+    emit(0x41); emit(0x56); // push r14
+    emit(0x41); emit(0x57); // push r15
+    // sub rsp, 8 (so calls to helpers have an aligned stack)
+    emit(0x48); emit(0x83); emit(0xEC); emit(0x08);
+    op_rr(false, true, 0x89, 1, RDI, RBP);
+    op_mem(false, true, 0x8B, 1, R12, RBP, -1, 1, offsetof(jit_state, stk));
+    op_mem(false, true, 0x8B, 1, RBX, RBP, -1, 1, offsetof(jit_state, info));
+    op_mem(false, true, 0x8B, 1, R15, RBP, -1, 1, offsetof(jit_state, table));
+    op_mem(false, false, 0x8B, 1, R13, RBP, -1, 1, offsetof(jit_state, bp));
+    op_mem(false, true, 0x8D, 1, R14, R12, R13, 2, 0);
+    op_mem(false, false, 0x8B, 1, RAX, RBP, -1, 1, offsetof(jit_state, pc));
+    op_mem(false, false, 0xFF, 1, 4, R15, RAX, 8, 0);
+
+    epilogue_off = buf_len;
+    op_mem(false, false, 0x89, 1, R13, RBP, -1, 1, offsetof(jit_state, bp));
+    emit(0x48); emit(0x83); emit(0xC4); emit(0x08); // add rsp, 8
+    emit(0x41); emit(0x5F); // pop r15
+    emit(0x41); emit(0x5E); // pop r14
+    emit(0x41); emit(0x5D); // pop r13
+    emit(0x41); emit(0x5C); // pop r12
+    emit(0x5D); // pop rbp
+    emit(0x5B); // pop rbx
+    emit(0xC3); // ret
+}
+
+// Return a new array of n elements of the given size, bailing if
+// there is not enough space
+static void *allocate(size_t n, size_t size)
+{
+    void *ret = calloc(n, size);
+    if (ret == NULL) {
+	bail_with_error("Not enough space for the JIT!");
+    }
+    return ret;
+}
+
+// Is there a JIT for this machine?
+bool jit_available()
+{
+    return true;
+}
+
+// Requires: code has size elements
+// Translate the program (which verified, with the results in info)
+// into buf, and fill in table; return false if the code buffer
+// cannot be made executable
+static bool generate(instruction code[], int size, verified_instr info[],
+		     const uint8_t *table[])
+{
+    // no instruction needs more than 128 bytes (with its stub)
+    buf_cap = 128 * (size_t) size + 4096;
+    void *mem = mmap(NULL, buf_cap, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+	buf = NULL;
+	return false;
+    }
+    buf = mem;
+    buf_len = 0;
+    // each instruction has at most 4 jumps
+    fixups = allocate(4 * (size_t) size, sizeof(fixup));
+    num_fixups = 0;
+    native_off = allocate(size, sizeof(size_t));
+    stub_off = allocate(size, sizeof(size_t));
+
+    emit_prologue_and_epilogue();
+    for (int pc = 0; pc < size; pc++) {
+	native_off[pc] = buf_len;
+	if (info[pc].height < 0) {
+	    // unreachable, so jumps there are never taken
+	    emit(0x0F); emit(0x0B); // ud2
+	} else {
+	    translate(code[pc], pc, info[pc].height, size, info);
+	}
+    }
+    // the fallback stubs, out of the way of the rest of the code
+    for (int pc = 0; pc < size; pc++) {
+	if (stub_off[pc] != 0) {
+	    stub_off[pc] = buf_len;
+	    emit_exit(pc, info[pc].height, JIT_FALLBACK);
+	}
+    }
+    for (int i = 0; i < num_fixups; i++) {
+	size_t target = fixups[i].to_stub ? stub_off[fixups[i].pc]
+	    : native_off[fixups[i].pc];
+	size_t at = fixups[i].at;
+	int32_t rel = (int32_t) ((int64_t) target - (int64_t) (at + 4));
+	for (int b = 0; b < 4; b++) {
+	    buf[at + b] = ((uint32_t) rel >> (8*b)) & 0xff;
+	}
+    }
+    for (int pc = 0; pc < size; pc++) {
+	table[pc] = buf + native_off[pc];
+    }
+    free(fixups);
+    free(native_off);
+    free(stub_off);
+    return mprotect(buf, buf_cap, PROT_READ | PROT_EXEC) == 0;
+}
+
+// Give back the space used by the compiled program prog (if not NULL)
+void jit_free(struct jit_program *prog)
+{
+    if (prog == NULL) {
+	return;
+    }
+    munmap(prog->code, prog->code_size);
+    free(prog->table);
+    free(prog);
+}
+
+// Return vm's program compiled for the maximum height of its stack
+// (compiling it if that was not done already), or NULL if the code
+// buffer cannot be made executable
+static struct jit_program *compile(vm_t *vm)
+{
+    max_height = stack_max_height(&vm->stack);
+    fueled = (vm->fuel_limit != 0);
+    if (vm->jit != NULL && vm->jit->max_height == max_height
+	&& vm->jit->fueled == fueled) {
+	return vm->jit;
+    }
+    jit_free(vm->jit);
+    vm->jit = NULL;
+    int size = vm->code_size;
+    struct jit_program *prog = allocate(1, sizeof(struct jit_program));
+    prog->table = allocate(size > 0 ? size : 1, sizeof(uint8_t *));
+    prog->max_height = max_height;
+    prog->fueled = fueled;
+    bool ok = generate(vm->code, size, vm->info, prog->table);
+    prog->code = buf;
+    prog->code_size = buf_cap;
+    if (buf == NULL || !ok) {
+	if (buf != NULL) {
+	    munmap(buf, buf_cap);
+	}
+	free(prog->table);
+	free(prog);
+	// mmap or mprotect failed, which must not show up
+	// in later error messages
+	errno = 0;
+	return NULL;
+    }
+    vm->jit = prog;
+    return prog;
+}
+
+// Run vm's program with the JIT if it verifies, starting at vm->PC,
+// returning true if it halts and false if it must continue
+// in a checked interpreter (or did not start)
+bool jit_run(vm_t *vm)
+{
+    if (!machine_verify(vm)) {
+	return false;
+    }
+    verified_instr *info = vm->info;
+    int pc = vm->PC;
+    int sp = stack_size(&vm->stack);
+    int bp = stack_AR_base(&vm->stack);
+    // the check the threaded engine's unchecked mode makes on entry
+    if (pc >= vm->code_size || sp - bp != info[pc].height
+	|| bp + info[pc].frame_size >= stack_max_height(&vm->stack)) {
+	return false;
+    }
+    struct jit_program *prog = compile(vm);
+    if (prog == NULL) {
+	return false;
+    }
+    jit_state st = { stack_storage(&vm->stack), info, prog->table, &vm->io,
+		     vm->display, pc, sp, bp, vm->fuel };
+    int (*run)(jit_state *) = (int (*)(jit_state *)) (void *) prog->code;
+    bool halted = (run(&st) == JIT_HALTED);
+    vm->PC = st.pc;
+    stack_set_registers(&vm->stack, st.sp, st.bp);
+    vm->fuel = st.fuel;
+    return halted;
+}
+
+#endif // HAVE_JIT
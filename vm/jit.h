@@ -0,0 +1,29 @@
+#ifndef _JIT_H
+#define _JIT_H
+#include <stdbool.h>
+#include "machine.h"
+
+// Is there a JIT for this machine? (Only x86-64 Unix systems have one.)
+extern bool jit_available();
+
+// Requires: vm's program is loaded and 0 <= vm->PC
+// If the JIT is available and vm's program verifies (see verifier.h),
+// translate it to x86-64 machine code (or use the code from an earlier
+// run, which is kept in vm->jit) and run that, starting at vm->PC,
+// until a HLT instruction is executed (then set vm->PC to the address
+// after that HLT and return true), or until a check at a CAL or RTN
+// fails as in the threaded engine's unchecked mode, or a CAL or backward
+// jump finds that vm has no fuel left (then set vm->PC to the
+// address of that instruction, so a checked interpreter can continue
+// from there, and return false).
+// Return false without running anything if there is no JIT
+// or the program does not verify.
+// The stack stays in vm's stack storage, and its registers
+// are up to date when this returns.
+// Errors are reported exactly as in execute().
+extern bool jit_run(vm_t *vm);
+
+// Give back the space used by the compiled program prog
+// (from vm->jit, which may be NULL)
+extern void jit_free(struct jit_program *prog);
+#endif
@@ -1,297 +1,756 @@
-/* $Id: machine.c,v 1.27 2023/03/27 14:10:39 leavens Exp leavens $ */
-#include <stdlib.h>
-#include <stdbool.h>
-#include <assert.h>
-#include <stdarg.h>
-#include "instruction.h"
-#include "utilities.h"
-#include "stack.h"
-#include "machine.h"
-
-extern void initialize();
-extern int read_program(FILE *prog);
-extern void print_program(FILE *out, int size);
-
-FILE *open_instruction_file(const char *filename)
-{
-    FILE *f = fopen(filename, "r");
-    if (f == NULL) {
-	bail_with_error("Cannot open file '%s'", filename);
-    }
-    return f;
-}
-
-void close_instruction_file(FILE *prog)
-{
-    int fcrv = fclose(prog);
-    if (fcrv == EOF) {
-	bail_with_error("Cannot close stream for program file");
-    }
-}
-
-// print tracing output?
-bool tracing = true;
-
-// stop the program's execution (false keeps it running)
-static bool halt;
-
-static instruction code[MAX_CODE_LENGTH];
-
-// the program counter
-static int PC;
-
-void machine(const char *filename)
-{
-    initialize();
-    FILE *prog = open_instruction_file(filename);
-    int prog_size = read_program(prog);
-    close_instruction_file(prog);
-    if (tracing) {
-	print_program(stderr, prog_size);
-	fprintf(stderr, "Tracing ...\n");
-	print_state(stderr);
-    }
-    while (!halt) {
-	trace_execute(stderr, code[PC]);
-    }
-    return;
-}
-
-
-// read the program from the given filename
-int read_program(FILE * prog)
-{
-    int count = 0;
-    while (count < MAX_CODE_LENGTH) {
-	code[count] = read_instruction(prog);
-
-	if (stop_reading) {
-	    break;
-	} else {
-	    count++;
-	}
-    }
-    if (count >= MAX_CODE_LENGTH) {
-	bail_with_error("Error: too many instructions!");
-    }
-    return count;
-}
-
-// print all the instructions in the program to out
-void print_program(FILE *out, int size)
-{
-    // print the table of output header
-    print_instruction_heading(out);
-    // print the instructions in order
-    for (int i = 0; i < size; i++) {
-	print_instr_with_addr(out, i, code[i]);
-    }
-}
-
-// Requires: out is open for writing
-// Print instr, execute instr, then the machine's state (to the file out)
-void trace_execute(FILE *out, instruction instr)
-{
-    if (tracing) {
-	fprintf(out, "==> addr: ");
-	print_instr_with_addr(out, PC, instr);
-    }
-    execute(instr);
-    if (tracing) {
-	print_state(out);
-    }
-}
-
-// Execute the given instruction, setting halt to true if the machine
-// should halt (due to a HLT instruction being executed).
-void execute(instruction instr)
-{
-    PC++;
-    halt = false;
-    switch (instr.op) {
-    case 0: // NOP
-	// do nothing
-	break;
-    case 1: // LIT
-	stack_push(instr.m);
-	break;
-    case 2: // RTN
-	stack_return(&PC); // restore old PC
-	break;
-    case 3: // CAL
-	stack_call(PC); // save old PC and set static link
-	PC = instr.m;
-	break;
-    case 4: // POP
-	stack_pop();
-	break;
-    case 5: // PSI
-	{
-	    int addr = stack_pop();
-	    stack_push(stack_fetch(addr));
-	}
-	break;
-    case 6: // LOD
-      {
-	address loc = stack_pop() + instr.m;
-	stack_push(stack_fetch(loc));
-      }
-	break;
-    case 7: // ST0
-      {
-	word val = stack_pop();
-	address dest = stack_pop() + instr.m;
-	stack_assign(dest, val);
-      }
-	break;
-    case 8: // INC
-	stack_allocate(instr.m);
-	break;
-    case 9: // JMP
-	PC = PC - 1 + instr.m;
-	break;
-    case 10: // JPC
-	{
-	    word top_elem = stack_pop();
-	    if (top_elem != 0) {
-		PC = PC - 1 + instr.m;
-	    }
-	}
-	break;
-    case 11: // CHO
-	fputc(stack_pop(), stdout);
-	break;
-    case 12: // CHI
-	stack_push(fgetc(stdin));
-	break;
-    case 13: // HLT
-	halt = true;
-	break;
-    case 14: // NDB
-	tracing = false;
-	break;
-    case 15: // NEG
-	stack_push(- stack_pop());
-	break;
-    case 16: // ADD
-	{    // C technically doesn't guarantee ordering inside expressions
-	    word topval = stack_pop();
-	    word second = stack_pop();
-	    stack_push(second+topval);
-	}
-	break;
-    case 17: // SUB
-	{   // C technically doesn't guarantee ordering inside expressions
-	    int topval = stack_pop();
-	    int second = stack_pop();
-	    stack_push(second - topval);
-	}
-	break;
-    case 18: // MUL
-	{    // C technically doesn't guarantee ordering inside expressions
-	    word topval = stack_pop();
-	    word second = stack_pop();
-	    stack_push(second*topval);
-	}
-	break;
-    case 19: // DIV
-	{    // C technically doesn't guarantee ordering inside expressions
-	    word topval = stack_pop();
-	    word second = stack_pop();
-	    if (topval == 0) {
-		bail_with_error("Divisor is zero in DIV instruction!");
-	    }
-	    stack_push(second / topval);
-	}
-	break;
-    case 20: // MOD
-	{
-	    word topval = stack_pop();
-	    word second = stack_pop();
-	    if (topval == 0) {
-		bail_with_error("Modulus is zero in MOD instruction!");
-	    }
-	    stack_push(second % topval);
-	}
-	break;
-    case 21: // EQL
-	stack_push(stack_pop() == stack_pop());
-	break;
-    case 22: // NEQ
-	stack_push(stack_pop() != stack_pop());
-	break;
-    case 23: // LSS
-	{   // C technically doesn't guarantee ordering inside expressions
-	    int topval = stack_pop();
-	    int second = stack_pop();
-	    stack_push(second < topval);
-	}
-	break;
-    case 24: // LEQ
-	{   // C technically doesn't guarantee ordering inside expressions
-	    int topval = stack_pop();
-	    int second = stack_pop();
-	    stack_push(second <= topval);
-	}
-	break;
-    case 25: // GTR
-	{   // C technically doesn't guarantee ordering inside expressions
-	    int topval = stack_pop();
-	    int second = stack_pop();
-	    stack_push(second > topval);
-	}
-	break;
-    case 26: // GEQ
-	{   // C technically doesn't guarantee ordering inside expressions
-	    int topval = stack_pop();
-	    int second = stack_pop();
-	    stack_push(second >= topval);
-	}
-	break;
-    case 27: // PSP
-	stack_push(stack_size());
-	break;
-    case 28: // PBP
-	stack_push(stack_AR_base());
-	break;
-    case 29: // PPC
-	stack_push(PC);
-	break;
-    case 30: // JMI
-	PC = stack_pop();
-	break;
-    default:
-	bail_with_error("Undefined opcode: %d", instr.op);
-	break;
-    }
-}
-
-// invariant test for the VM (for debugging purposes)
-void okay()
-{
-    assert(0 <= PC && PC < MAX_CODE_LENGTH);
-}
-
-// Initialization of the VM
-void initialize()
-{
-    stack_initialize();
-    stop_reading = false;
-    halt = false;
-    tracing = true;
-    instruction zero_instruction = {0,0};
-    // initialize the code array
-    for (int i = 0; i < MAX_CODE_LENGTH; i++) {
-	code[i] = zero_instruction;
-    }
-    PC = 0;
-}
-
-void print_state(FILE *out)
-{
-    // control registers
-    fprintf(out, "PC: %d BP: %d SP: %d\n", PC, stack_AR_base(), stack_size());
-    // stack between BP and SP
-    fprintf(out, "stack: ");
-    stack_print(out);
-}
+/* $Id: machine.c,v 1.27 2023/03/27 14:10:39 leavens Exp leavens $ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <assert.h>
+#include <stdarg.h>
+#include "instruction.h"
+#include "utilities.h"
+#include "stack.h"
+#include "machine.h"
+#include "bytecode.h"
+#include "char_io.h"
+#include "fusion.h"
+#include "threaded.h"
+#include "jit.h"
+#include "profile.h"
+
+static instruction current_instruction(vm_t *vm);
+static inline packed_instr current_packed(vm_t *vm);
+static void execute_op(vm_t *vm, int op, int m);
+
+FILE *open_instruction_file(const char *filename)
+{
+    FILE *f = fopen(filename, "r");
+    if (f == NULL) {
+	bail_with_error("Cannot open file '%s'", filename);
+    }
+    return f;
+}
+
+void close_instruction_file(FILE *prog)
+{
+    int fcrv = fclose(prog);
+    if (fcrv == EOF) {
+	bail_with_error("Cannot close stream for program file");
+    }
+}
+
+// Set up vm with no program and the default options
+void machine_create(vm_t *vm)
+{
+    stack_create(&vm->stack);
+    char_io_create(&vm->io);
+    vm->tracing = true;
+    vm->engine = engine_threaded;
+    vm->fusing = true;
+    vm->fusion_stats = false;
+    vm->profiling = false;
+    vm->measuring = false;
+    vm->code = NULL;
+    vm->code_size = 0;
+    vm->code_capacity = 0;
+    vm->mapping = NULL;
+    vm->mapping_size = 0;
+    vm->packed = NULL;
+    vm->escapes = NULL;
+    vm->fused = NULL;
+    vm->entry = 0;
+    vm->PC = 0;
+    vm->halt = false;
+    profile_create(&vm->profile);
+    trace_create(&vm->trace);
+    counters_create(&vm->counters);
+    vm->cells = NULL;
+    vm->info = NULL;
+    vm->verified = -1;
+    vm->jit = NULL;
+    vm->budget_limited = false;
+    vm->budget = 0;
+    vm->counting = false;
+    vm->executed = 0;
+    vm->fuel_limit = 0;
+    vm->fuel = ULONG_MAX;
+    vm->failed = false;
+}
+
+// Give back the space used by vm's program and the engines' code
+static void unload(vm_t *vm)
+{
+    if (vm->code_capacity > 0) {
+	free(vm->code);
+    }
+    vm->code = NULL;
+    vm->code_size = 0;
+    vm->code_capacity = 0;
+    if (vm->mapping != NULL) {
+	bytecode_unload(vm->mapping, vm->mapping_size);
+    }
+    vm->mapping = NULL;
+    vm->mapping_size = 0;
+    free(vm->packed);
+    vm->packed = NULL;
+    free(vm->escapes);
+    vm->escapes = NULL;
+    free(vm->fused);
+    vm->fused = NULL;
+    free(vm->cells);
+    vm->cells = NULL;
+    free(vm->info);
+    vm->info = NULL;
+    vm->verified = -1;
+    jit_free(vm->jit);
+    vm->jit = NULL;
+}
+
+// Give back the space used by vm's program and engines
+void machine_destroy(vm_t *vm)
+{
+    unload(vm);
+    profile_destroy(&vm->profile);
+    trace_destroy(&vm->trace);
+    counters_destroy(&vm->counters);
+    char_io_destroy(&vm->io);
+    stack_destroy(&vm->stack);
+}
+
+// Put vm's stack, I/O, and registers as they are before its program
+// starts running (from vm->entry)
+static void reset(vm_t *vm)
+{
+    stack_initialize(&vm->stack);
+    char_io_initialize(&vm->io);
+    vm->halt = false;
+    vm->failed = false;
+    vm->PC = vm->entry;
+    for (int i = 0; i < DISPLAY_SIZE; i++) {
+	vm->display[i] = 0;
+    }
+    vm->executed = 0;
+    vm->fuel = (vm->fuel_limit == 0) ? ULONG_MAX : vm->fuel_limit;
+    for (int i = 0; i < NUM_FUSIONS; i++) {
+	vm->fusion_hits[i] = 0;
+    }
+}
+
+// Initialization of the VM, before its program is loaded
+static void initialize(vm_t *vm)
+{
+    unload(vm);
+    vm->entry = 0;
+    reset(vm);
+}
+
+// Start the profile and the binary trace of a run, if they are on
+static void start_run(vm_t *vm)
+{
+    if (vm->profiling) {
+	profile_start(&vm->profile, vm->code, vm->code_size,
+		      stack_size(&vm->stack));
+    }
+    if (trace_enabled(&vm->trace)) {
+	trace_start(&vm->trace);
+    }
+}
+
+// Finish loading the program (in vm->code) by fusing it
+// and starting the profile
+static void prepare(vm_t *vm)
+{
+    vm->fused = (fused_instr *)
+	malloc(sizeof(fused_instr) * (vm->code_size + 1));
+    if (vm->fused == NULL) {
+	bail_with_error("Not enough space for %d instructions!",
+			vm->code_size);
+    }
+    fuse_program(vm->code, vm->code_size, vm->fused, vm->fusing);
+    start_run(vm);
+}
+
+// Pack vm's program for the switch engine, the only one that runs
+// the packed code, so it is made only when that engine first runs
+// (and kept for later runs of the program)
+static void pack(vm_t *vm)
+{
+    if (vm->packed != NULL) {
+	return;
+    }
+    vm->packed = (packed_instr *)
+	malloc(sizeof(packed_instr) * (vm->code_size + 1));
+    if (vm->packed == NULL
+	|| !pack_program(vm->code, vm->code_size, vm->packed,
+			 &vm->escapes)) {
+	bail_with_error("Not enough space for %d instructions!",
+			vm->code_size);
+    }
+}
+
+// read the program from the given file into vm,
+// growing the code array as needed
+static void read_program(vm_t *vm, FILE *prog)
+{
+    bool stop_reading = false;
+    int count = 0;
+    for (;;) {
+	if (count == vm->code_capacity) {
+	    vm->code_capacity = (vm->code_capacity == 0)
+		? 512 : 2 * vm->code_capacity;
+	    vm->code = (instruction *)
+		realloc(vm->code, sizeof(instruction) * vm->code_capacity);
+	    if (vm->code == NULL) {
+		bail_with_error("Not enough space for %d instructions!",
+				vm->code_capacity);
+	    }
+	}
+	vm->code[count] = read_instruction(prog, &stop_reading);
+
+	if (stop_reading) {
+	    break;
+	} else {
+	    count++;
+	}
+    }
+    vm->code_size = count;
+}
+
+// Load the program in the VM's text format from prog into vm
+void machine_load_text(vm_t *vm, FILE *prog)
+{
+    initialize(vm);
+    read_program(vm, prog);
+    prepare(vm);
+}
+
+// Load the program in code (size instructions) into vm,
+// to start at address entry, where code is in the mapping
+// (of mapping_size bytes) made by bytecode_load, or mapping is NULL
+static void load_code(vm_t *vm, instruction *code, int size, bool owned,
+		      int entry, const void *mapping, size_t mapping_size)
+{
+    initialize(vm);
+    vm->code = code;
+    vm->code_size = size;
+    vm->code_capacity = owned ? size : 0;
+    // set before prepare, which may bail, so the mapping is not leaked
+    vm->mapping = mapping;
+    vm->mapping_size = mapping_size;
+    vm->entry = entry;
+    vm->PC = entry;
+    prepare(vm);
+}
+
+// Load the program in code (size instructions) into vm,
+// to start at address entry
+void machine_load_code(vm_t *vm, instruction *code, int size, bool owned,
+		       int entry)
+{
+    load_code(vm, code, size, owned, entry, NULL, 0);
+}
+
+// Put vm back in the state its program was in when it was loaded
+void machine_restart(vm_t *vm)
+{
+    reset(vm);
+    start_run(vm);
+}
+
+// Return whether vm's program verifies (see verifier.h)
+bool machine_verify(vm_t *vm)
+{
+    if (vm->verified < 0) {
+	vm->info = (verified_instr *)
+	    malloc(sizeof(verified_instr) * (vm->code_size + 1));
+	if (vm->info == NULL) {
+	    bail_with_error("Not enough space for the verifier's results!");
+	}
+	vm->verified = verify_program(vm->code, vm->code_size, vm->info);
+    }
+    return vm->verified;
+}
+
+// Use up one instruction of vm's budget (and count it),
+// returning false if there is none left
+static bool take_step(vm_t *vm)
+{
+    if (vm->budget_limited) {
+	if (vm->budget == 0) {
+	    return false;
+	}
+	vm->budget--;
+    }
+    vm->executed++;
+    return true;
+}
+
+// Limit vm's programs to fuel calls and backward jumps (0 for no limit)
+void machine_set_fuel(vm_t *vm, unsigned long fuel)
+{
+    vm->fuel_limit = fuel;
+    vm->fuel = (fuel == 0) ? ULONG_MAX : fuel;
+}
+
+// Report that the call or backward jump at pc needs more fuel
+void machine_out_of_fuel(vm_t *vm, int pc)
+{
+    unsigned long used = vm->fuel_limit - vm->fuel;
+    if (STEPPING(vm)) {
+	bail_with_error("Out of fuel at PC %d after %lu instructions"
+			" (%lu calls and backward jumps)!",
+			pc, vm->executed, used);
+    }
+    bail_with_error("Out of fuel at PC %d after %lu calls"
+		    " and backward jumps!", pc, used);
+}
+
+// Use up one unit of vm's fuel for the call or backward jump at pc
+static void use_fuel(vm_t *vm, int pc)
+{
+    if (vm->fuel == 0) {
+	machine_out_of_fuel(vm, pc);
+    }
+    vm->fuel--;
+}
+
+// Run vm's program from its PC until it halts (returning true),
+// or until its budget runs out (returning false)
+bool machine_run(vm_t *vm)
+{
+    while (!vm->halt && vm->tracing) {
+	if (!take_step(vm)) {
+	    return false;
+	}
+	if (vm->profiling) {
+	    PROFILE_STEP(&vm->profile, vm->PC, stack_size(&vm->stack));
+	}
+	if (TRACE_RECORDING(&vm->trace)) {
+	    int pc = vm->PC;
+	    instruction instr = current_instruction(vm);
+	    execute(vm, instr);
+	    TRACE_STEP(&vm->trace, pc, instr, vm->PC, &vm->stack);
+	} else {
+	    trace_execute(vm, stderr, current_instruction(vm));
+	}
+    }
+    // tracing is off (from the start or after an NDB instruction)
+    if (vm->halt) {
+	return true;
+    }
+    switch (vm->engine) {
+    case engine_jit:
+	// the JIT's code cannot be profiled, counted, or stopped by a budget
+	if (!STEPPING(vm) && jit_run(vm)) {
+	    vm->halt = true;
+	    break;
+	}
+	// continue in the checked threaded engine, from the CAL or RTN
+	// whose check failed (or from the start, if the JIT did not run)
+	vm->halt = threaded_run(vm, false);
+	break;
+    case engine_checked:
+    case engine_threaded:
+	vm->halt = threaded_run(vm, vm->engine != engine_checked);
+	break;
+    default:
+	pack(vm);
+	while (!vm->halt) {
+	    if (!take_step(vm)) {
+		return false;
+	    }
+	    if (vm->profiling) {
+		PROFILE_STEP(&vm->profile, vm->PC, stack_size(&vm->stack));
+	    }
+	    // decoded with a mask and a shift (see PACKED_ESCAPE
+	    // in execute_op for the instructions that were escaped)
+	    packed_instr w = current_packed(vm);
+	    execute_op(vm, PACKED_OP(w), PACKED_M(w));
+	}
+	break;
+    }
+    return vm->halt;
+}
+
+// Load the program in the file named filename into vm
+// if it is in the bytecode format, returning whether it is
+bool machine_load_bytecode(vm_t *vm, const char *filename)
+{
+    instruction *code;
+    int entry;
+    const void *mapping;
+    size_t mapping_size;
+    int size = bytecode_load(filename, &code, &entry, &mapping,
+			     &mapping_size);
+    if (size < 0) {
+	return false;
+    }
+    // the mapped instructions are used where they are
+    load_code(vm, code, size, false, entry, mapping, mapping_size);
+    return true;
+}
+
+// Load the program in the file named filename into vm
+void machine_load_file(vm_t *vm, const char *filename)
+{
+    if (!machine_load_bytecode(vm, filename)) {
+	// not in the bytecode format, so read it as text
+	FILE *prog = open_instruction_file(filename);
+	machine_load_text(vm, prog);
+	close_instruction_file(prog);
+    }
+}
+
+// Run the program in the file named filename in vm
+void machine(vm_t *vm, const char *filename)
+{
+    machine_load_file(vm, filename);
+    if (vm->tracing && !TRACE_RECORDING(&vm->trace)) {
+	print_program(vm, stderr);
+	fprintf(stderr, "Tracing ...\n");
+	print_state(vm, stderr);
+    }
+    if (vm->measuring) {
+	counters_start(&vm->counters);
+    }
+    machine_run(vm);
+    if (vm->measuring) {
+	counters_stop(&vm->counters);
+    }
+    // the machine has halted
+    char_io_flush(&vm->io);
+    if (vm->fusion_stats) {
+	fusion_print_stats(stderr, vm->fused, vm->code_size,
+			   vm->fusion_hits);
+    }
+    if (vm->profiling) {
+	profile_finish(&vm->profile, true, stack_size(&vm->stack));
+    }
+    if (vm->measuring) {
+	machine_report_counters(vm, stderr, true);
+    }
+    return;
+}
+
+// Did vm count every instruction it executed?
+bool machine_counted(vm_t *vm)
+{
+    // every instruction is counted by the switch engine and when
+    // stepping, but not by the faster engines, so as not to slow them
+    return STEPPING(vm) || vm->engine == engine_switch;
+}
+
+// Return the name of the engine that runs vm's programs
+const char *machine_engine_name(vm_t *vm)
+{
+    static const char *engine_names[] = {
+	"switch", "checked", "threaded", "jit"
+    };
+    bool stepped = STEPPING(vm) && vm->engine != engine_switch;
+    return stepped ? "checked (stepped)" : engine_names[vm->engine];
+}
+
+// Report the counters of vm's run on out (only once)
+void machine_report_counters(vm_t *vm, FILE *out, bool halted)
+{
+    counters_vm_counts counts;
+    bool stepped = STEPPING(vm) && vm->engine != engine_switch;
+    counts.engine = machine_engine_name(vm);
+    counts.instructions_known = machine_counted(vm);
+    counts.instructions = vm->executed;
+    // neither of which fuses instructions
+    counts.dispatches_known = counts.instructions_known;
+    counts.dispatches = vm->executed;
+    // all but the JIT's code use up fuel, even when it is not limited
+    counts.calls_known = stepped || vm->engine != engine_jit
+	|| vm->fuel_limit != 0;
+    counts.calls = ((vm->fuel_limit == 0) ? ULONG_MAX : vm->fuel_limit)
+	- vm->fuel;
+    counters_report(&vm->counters, out, halted, &counts);
+}
+
+
+// Return the address of vm's display entry for level m
+address *machine_display_entry(vm_t *vm, int m)
+{
+    if (m < 0 || m >= DISPLAY_SIZE) {
+	bail_with_error("Illegal display level (%d), must be less than %d!",
+			m, DISPLAY_SIZE);
+    }
+    return &vm->display[m];
+}
+
+// Requires: vm's program has been packed (see pack)
+// Return the packed instruction at address PC,
+// bailing if PC is not the address of an instruction
+static inline packed_instr current_packed(vm_t *vm)
+{
+    if ((unsigned int) vm->PC >= (unsigned int) vm->code_size) {
+	bail_with_error("PC (%d) is outside the code!", vm->PC);
+    }
+    return vm->packed[vm->PC];
+}
+
+// Return the instruction at address PC,
+// bailing if PC is not the address of an instruction
+static instruction current_instruction(vm_t *vm)
+{
+    if ((unsigned int) vm->PC >= (unsigned int) vm->code_size) {
+	bail_with_error("PC (%d) is outside the code!", vm->PC);
+    }
+    return vm->code[vm->PC];
+}
+
+// print all the instructions in the program to out
+void print_program(vm_t *vm, FILE *out)
+{
+    // print the table of output header
+    print_instruction_heading(out);
+    // print the instructions in order
+    for (int i = 0; i < vm->code_size; i++) {
+	print_instr_with_addr(out, i, vm->code[i]);
+    }
+}
+
+// Requires: out is open for writing
+// Print instr, execute instr, then the machine's state (to the file out)
+void trace_execute(vm_t *vm, FILE *out, instruction instr)
+{
+    if (vm->tracing) {
+	fprintf(out, "==> addr: ");
+	print_instr_with_addr(out, vm->PC, instr);
+    }
+    execute(vm, instr);
+    if (vm->tracing) {
+	print_state(vm, out);
+    }
+}
+
+// Execute the instruction with opcode op and the given m,
+// as execute does, or the escaped instruction with index m
+// if op is PACKED_ESCAPE
+static void execute_op(vm_t *vm, int op, int m)
+{
+    vm->PC++;
+    vm->halt = false;
+    switch (op) {
+    case 0: // NOP
+	// do nothing
+	break;
+    case 1: // LIT
+	stack_push(&vm->stack, m);
+	break;
+    case 2: // RTN
+	stack_return(&vm->stack, &vm->PC); // restore old PC
+	break;
+    case 3: // CAL
+	use_fuel(vm, vm->PC - 1);
+	stack_call(&vm->stack, vm->PC); // save old PC and set static link
+	vm->PC = m;
+	break;
+    case 4: // POP
+	stack_pop(&vm->stack);
+	break;
+    case 5: // PSI
+	{
+	    int addr = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, stack_fetch(&vm->stack, addr));
+	}
+	break;
+    case 6: // LOD
+      {
+	address loc = stack_pop(&vm->stack) + m;
+	stack_push(&vm->stack, stack_fetch(&vm->stack, loc));
+      }
+	break;
+    case 7: // ST0
+      {
+	word val = stack_pop(&vm->stack);
+	address dest = stack_pop(&vm->stack) + m;
+	stack_assign(&vm->stack, dest, val);
+      }
+	break;
+    case 8: // INC
+	stack_allocate(&vm->stack, m);
+	break;
+    case 9: // JMP
+	if (m <= 0) {
+	    use_fuel(vm, vm->PC - 1);
+	}
+	vm->PC = vm->PC - 1 + m;
+	break;
+    case 10: // JPC
+	{
+	    word top_elem = stack_pop(&vm->stack);
+	    if (top_elem != 0) {
+		if (m <= 0) {
+		    use_fuel(vm, vm->PC - 1);
+		}
+		vm->PC = vm->PC - 1 + m;
+	    }
+	}
+	break;
+    case 11: // CHO
+	char_io_put(&vm->io, stack_pop(&vm->stack));
+	break;
+    case 12: // CHI
+	stack_push(&vm->stack, char_io_get(&vm->io));
+	break;
+    case 13: // HLT
+	vm->halt = true;
+	break;
+    case 14: // NDB
+	vm->tracing = false;
+	break;
+    case 15: // NEG
+	stack_push(&vm->stack, - stack_pop(&vm->stack));
+	break;
+    case 16: // ADD
+	{    // C technically doesn't guarantee ordering inside expressions
+	    word topval = stack_pop(&vm->stack);
+	    word second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second+topval);
+	}
+	break;
+    case 17: // SUB
+	{   // C technically doesn't guarantee ordering inside expressions
+	    int topval = stack_pop(&vm->stack);
+	    int second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second - topval);
+	}
+	break;
+    case 18: // MUL
+	{    // C technically doesn't guarantee ordering inside expressions
+	    word topval = stack_pop(&vm->stack);
+	    word second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second*topval);
+	}
+	break;
+    case 19: // DIV
+	{    // C technically doesn't guarantee ordering inside expressions
+	    word topval = stack_pop(&vm->stack);
+	    word second = stack_pop(&vm->stack);
+	    if (topval == 0) {
+		bail_with_error("Divisor is zero in DIV instruction!");
+	    }
+	    stack_push(&vm->stack, second / topval);
+	}
+	break;
+    case 20: // MOD
+	{
+	    word topval = stack_pop(&vm->stack);
+	    word second = stack_pop(&vm->stack);
+	    if (topval == 0) {
+		bail_with_error("Modulus is zero in MOD instruction!");
+	    }
+	    stack_push(&vm->stack, second % topval);
+	}
+	break;
+    case 21: // EQL
+	stack_push(&vm->stack, stack_pop(&vm->stack) == stack_pop(&vm->stack));
+	break;
+    case 22: // NEQ
+	stack_push(&vm->stack, stack_pop(&vm->stack) != stack_pop(&vm->stack));
+	break;
+    case 23: // LSS
+	{   // C technically doesn't guarantee ordering inside expressions
+	    int topval = stack_pop(&vm->stack);
+	    int second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second < topval);
+	}
+	break;
+    case 24: // LEQ
+	{   // C technically doesn't guarantee ordering inside expressions
+	    int topval = stack_pop(&vm->stack);
+	    int second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second <= topval);
+	}
+	break;
+    case 25: // GTR
+	{   // C technically doesn't guarantee ordering inside expressions
+	    int topval = stack_pop(&vm->stack);
+	    int second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second > topval);
+	}
+	break;
+    case 26: // GEQ
+	{   // C technically doesn't guarantee ordering inside expressions
+	    int topval = stack_pop(&vm->stack);
+	    int second = stack_pop(&vm->stack);
+	    stack_push(&vm->stack, second >= topval);
+	}
+	break;
+    case 27: // PSP
+	stack_push(&vm->stack, stack_size(&vm->stack));
+	break;
+    case 28: // PBP
+	stack_push(&vm->stack, stack_AR_base(&vm->stack));
+	break;
+    case 29: // PPC
+	stack_push(&vm->stack, vm->PC);
+	break;
+    case 30: // JMI
+	vm->PC = stack_pop(&vm->stack);
+	break;
+    case 31: // PDB
+	stack_push(&vm->stack, *machine_display_entry(vm, m));
+	break;
+    case 32: // SDB
+	{
+	    address *entry = machine_display_entry(vm, m);
+	    address bp = stack_AR_base(&vm->stack);
+	    stack_assign(&vm->stack, bp, *entry);
+	    *entry = bp;
+	}
+	break;
+    case 33: // RDB
+	{
+	    address *entry = machine_display_entry(vm, m);
+	    *entry = stack_fetch(&vm->stack, stack_AR_base(&vm->stack));
+	}
+	break;
+    case 34: // CNL
+	use_fuel(vm, vm->PC - 1);
+	stack_call_no_stat_lnk(&vm->stack, vm->PC); // save old PC
+	vm->PC = m;
+	break;
+    case 35: // RNL
+	stack_return_no_stat_lnk(&vm->stack, &vm->PC); // restore old PC
+	break;
+    case PACKED_ESCAPE:
+	// not an opcode: m is the index of the instruction
+	// in the table of escaped instructions (see instruction.h)
+	vm->PC--;
+	execute(vm, vm->escapes[m]);
+	break;
+    default:
+	bail_with_error("Undefined opcode: %d", op);
+	break;
+    }
+}
+
+// Execute the given instruction, setting halt to true if the machine
+// should halt (due to a HLT instruction being executed).
+void execute(vm_t *vm, instruction instr)
+{
+    if (instr.op == PACKED_ESCAPE) {
+	// not an escape, as instr is not packed
+	vm->PC++;
+	vm->halt = false;
+	bail_with_error("Undefined opcode: %d", instr.op);
+    }
+    execute_op(vm, instr.op, instr.m);
+}
+
+// invariant test for the VM (for debugging purposes)
+void okay(vm_t *vm)
+{
+    assert(0 <= vm->PC && vm->PC < vm->code_size);
+}
+
+void print_state(vm_t *vm, FILE *out)
+{
+    // control registers
+    fprintf(out, "PC: %d BP: %d SP: %d\n", vm->PC,
+	    stack_AR_base(&vm->stack), stack_size(&vm->stack));
+    // stack between BP and SP
+    fprintf(out, "stack: ");
+    stack_print(&vm->stack, out);
+}
@@ -1,25 +1,211 @@
-/* $Id: machine.h,v 1.8 2023/03/22 14:28:25 leavens Exp leavens $ */
-#ifndef _MACHINE_H
-#define _MACHINE_H
-#include <stdio.h>
-#include <stdbool.h>
-
-// maximum height of the runtime stack
-#define MAX_STACK_HEIGHT 2048
-// maximum number of instructions in a program
-#define MAX_CODE_LENGTH 512
-
-// print tracing output?
-extern bool tracing;
-
-// print the state of the machine (named registers)
-extern void print_state(FILE *out);
-
-// Requires: out is open for writing
-// Print instr, execute instr, then the machine's state (to the file out)
-extern void trace_execute(FILE *out, instruction instr);
-
-// Execute the given instruction, setting halt to true if the machine
-// should halt (due to a HLT instruction being executed).
-extern void execute(instruction instr);
-#endif
+/* $Id: machine.h,v 1.8 2023/03/22 14:28:25 leavens Exp leavens $ */
+#ifndef _MACHINE_H
+#define _MACHINE_H
+#include <stdio.h>
+#include <stdbool.h>
+#include "vm_api.h"
+#include "instruction.h"
+#include "stack.h"
+#include "char_io.h"
+#include "utilities.h"
+#include "fusion.h"
+#include "profile.h"
+#include "trace.h"
+#include "counters.h"
+#include "verifier.h"
+
+// The state of one VM; everything the machine changes as it runs
+// is in here, so several VMs can run at once (see vm_api.h)
+struct vm {
+    // the stack and registers BP and SP (see stack.h)
+    vm_stack stack;
+    // the character I/O of CHO and CHI (see char_io.h)
+    char_io io;
+    // print tracing output?
+    bool tracing;
+    // the engine used to execute instructions when not tracing
+    engine_kind engine;
+    // fuse instructions (see fusion.h)?
+    bool fusing;
+    // print statistics about fused instructions when the program halts?
+    bool fusion_stats;
+    // count the executions of each instruction (see profile.h)?
+    bool profiling;
+    // measure the run with the hardware counters (see counters.h)?
+    bool measuring;
+
+    // the program's instructions (code_size of them, in an array
+    // with room for code_capacity, which is 0 if the array is not
+    // owned by the VM, as for a mapped bytecode file)
+    instruction *code;
+    int code_size;
+    int code_capacity;
+    // the bytecode file code is in (see bytecode_load), which is
+    // unmapped when the program is unloaded, or NULL if it is not mapped
+    const void *mapping;
+    size_t mapping_size;
+    // the code run by the switch engine, packed (see instruction.h),
+    // or NULL until that engine runs, and its escaped instructions
+    // (or NULL if there are none)
+    packed_instr *packed;
+    instruction *escapes;
+    // the code run by the threaded engines, after fusion (see fusion.h)
+    fused_instr *fused;
+    // the address the program starts at
+    int entry;
+    // the program counter
+    int PC;
+    // the display: the base of the most recent frame at each lexical
+    // level (see the PDB, SDB, and RDB instructions in instruction.h)
+    address display[DISPLAY_SIZE];
+    // stop the program's execution (false keeps it running)
+    bool halt;
+
+    // the executions of each fused instruction (when fusion_stats)
+    unsigned long fusion_hits[NUM_FUSIONS];
+    // the profile (when profiling)
+    profile_data profile;
+    // the binary trace, recorded instead of printing the text trace
+    // while tracing (see trace.h)
+    trace_data trace;
+    // the hardware counters and clocks of the run (when measuring)
+    counters_data counters;
+
+    // the threaded engines' code (see threaded.c), or NULL until needed
+    struct thread_cell *cells;
+    // what the verifier found out about the program (or NULL),
+    // and whether it verifies (-1 if not known yet)
+    verified_instr *info;
+    int verified;
+    // the program compiled by the JIT (see jit.h), or NULL
+    struct jit_program *jit;
+
+    // stop after budget more instructions (if budget_limited)?
+    bool budget_limited;
+    unsigned long budget;
+    // count the instructions executed (in executed)?
+    bool counting;
+    // the number of instructions executed since the program was loaded,
+    // counted when each instruction is run on its own (see STEPPING)
+    unsigned long executed;
+
+    // the most calls and backward jumps the program may make (see
+    // machine_set_fuel), or 0 if there is no limit, and how many more
+    // it may make (ULONG_MAX if there is no limit)
+    unsigned long fuel_limit;
+    unsigned long fuel;
+
+    // where errors go (when run through vm_api.h)
+    error_trap trap;
+    // has an error stopped the program?
+    bool failed;
+};
+
+// Must vm run each instruction on its own (unfused, in the checked
+// engine), to count it (or stop when the budget runs out)?
+#define STEPPING(vm)							\
+    ((vm)->profiling || (vm)->budget_limited || (vm)->counting)
+
+// Set up vm with no program and the default options
+// (tracing, the threaded engine, and fusion)
+extern void machine_create(vm_t *vm);
+
+// Give back the space used by vm's program and engines
+// (but not vm itself)
+extern void machine_destroy(vm_t *vm);
+
+// Requires: prog is open for reading
+// Load the program in the VM's text format from prog into vm,
+// with an empty stack
+extern void machine_load_text(vm_t *vm, FILE *prog);
+
+// Requires: code has size elements, which vm owns if owned is true
+// Load the program in code into vm, with an empty stack,
+// to start at address entry
+extern void machine_load_code(vm_t *vm, instruction *code, int size,
+			      bool owned, int entry);
+
+// If the file named filename is in the bytecode format,
+// load its program into vm, with an empty stack, and return true;
+// otherwise return false (and leave vm as it was).
+extern bool machine_load_bytecode(vm_t *vm, const char *filename);
+
+// Load the program in the file named filename (in the text or bytecode
+// format) into vm, with an empty stack
+extern void machine_load_file(vm_t *vm, const char *filename);
+
+// Open the file named filename for reading a program in the text format,
+// bailing with an error if it cannot be opened
+extern FILE *open_instruction_file(const char *filename);
+
+// Requires: prog is open
+// Close prog, bailing with an error if it cannot be closed
+extern void close_instruction_file(FILE *prog);
+
+// Requires: a program has been loaded into vm
+// Put vm back in the state its program was in when it was loaded
+// (with an empty stack, fresh I/O, and PC at its entry point),
+// keeping the program and what was made from it (the fused
+// and threaded code, what the verifier found, and the JIT's code)
+extern void machine_restart(vm_t *vm);
+
+// Run vm's program from its PC until it halts (returning true),
+// or until its budget runs out (returning false)
+extern bool machine_run(vm_t *vm);
+
+// Limit the programs vm runs to making fuel calls and backward jumps
+// (taken JMP and JPC instructions whose offset is not positive),
+// from now and from each time a program is loaded,
+// or remove the limit if fuel is 0.
+// The limit is checked only at those instructions, so that straight-line
+// code is not slowed down, yet no loop or recursion can run forever.
+extern void machine_set_fuel(vm_t *vm, unsigned long fuel);
+
+// Requires: vm has no fuel left (vm->fuel == 0)
+// Report that the call or backward jump at pc needs more fuel,
+// with the number of instructions executed, if they were counted,
+// as an error (so this does not return)
+extern void machine_out_of_fuel(vm_t *vm, int pc);
+
+// Return the address of vm's display entry for level m,
+// bailing with an error if there is no such level
+extern address *machine_display_entry(vm_t *vm, int m);
+
+// Did vm count every instruction it executed in vm->executed
+// (as it does when STEPPING, and in the switch engine)?
+extern bool machine_counted(vm_t *vm);
+
+// Return the name of the engine that runs vm's programs when not
+// tracing (as given to -e), or "checked (stepped)" if they are run
+// in the checked engine one instruction at a time (see STEPPING)
+extern const char *machine_engine_name(vm_t *vm);
+
+// Requires: out is open for writing, and vm is measuring
+// (and has started running its program)
+// Stop the counters of vm's run and report them on out (only once),
+// with the VM's counts of the run, saying whether vm halted
+extern void machine_report_counters(vm_t *vm, FILE *out, bool halted);
+
+// Return whether vm's program verifies (see verifier.h),
+// filling in vm->info the first time this is called for the program
+extern bool machine_verify(vm_t *vm);
+
+// Run the program in the file named filename (in the text or bytecode
+// format) in vm, as the vm program does
+extern void machine(vm_t *vm, const char *filename);
+
+// Requires: out is open for writing
+// print all the instructions in vm's program to out
+extern void print_program(vm_t *vm, FILE *out);
+
+// print the state of the machine (named registers)
+extern void print_state(vm_t *vm, FILE *out);
+
+// Requires: out is open for writing
+// Print instr, execute instr, then the machine's state (to the file out)
+extern void trace_execute(vm_t *vm, FILE *out, instruction instr);
+
+// Execute the given instruction, setting halt to true if the machine
+// should halt (due to a HLT instruction being executed).
+extern void execute(vm_t *vm, instruction instr);
+#endif
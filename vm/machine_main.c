@@ -1,45 +1,336 @@
-/* $Id: machine_main.c,v 1.8 2023/03/22 14:16:36 leavens Exp $ */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "instruction.h"
-#include "machine.h"
-
-/* Print a usage message on stderr 
-   and exit with failure. */
-static void usage(const char *cmdname)
-{
-    fprintf(stderr,
-	    "Usage: %s [-n] code-filename\n",
-	    cmdname);
-    exit(EXIT_FAILURE);
-}
-
-int main(int argc, char *argv[])
-{
-    extern void machine(const char *filename);
-
-    const char *cmdname = argv[0];
-    argc--;
-    argv++;
-    // default is to print the program and do tracing
-    tracing = true;
-    // possible option: -n
-    if (argc > 1 && argv[0][0] == '-') {
-	// -n turns off tracing
-	if (strcmp(argv[0], "-n") == 0) {
-	    tracing = false;
-	    argc--;
-	    argv++;
-	} else {
-	    usage(cmdname);
-	}
-    }
-    
-    /* process file name argument */
-    if (argc != 1 || argv[0][0] == '-') {
-	    usage(cmdname);
-    }
-    machine(argv[0]);
-    return EXIT_SUCCESS;
-}
+/* $Id: machine_main.c,v 1.8 2023/03/22 14:16:36 leavens Exp $ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "instruction.h"
+#include "machine.h"
+#include "fusion.h"
+#include "stack.h"
+#include "char_io.h"
+#include "utilities.h"
+#include "jit.h"
+#include "profile.h"
+#include "batch.h"
+#include "trace.h"
+#include "server.h"
+#include "input_log.h"
+
+// the VM that runs the program
+static vm_t *vm;
+
+// the log its input is recorded in or replayed from (see input_log.h)
+static input_log in_log;
+
+// When the program exits (after the machine halts, or on an error),
+// report the profile (if it was not already), write out
+// the program's output, and (on an error) report the counters,
+// write the input log, and print the last steps traced
+static void finish_at_exit()
+{
+    if (vm->profiling) {
+	profile_finish(&vm->profile, false, stack_size(&vm->stack));
+    }
+    char_io_flush(&vm->io);
+    if (vm->measuring && vm->counters.running) {
+	machine_report_counters(vm, stderr, false);
+    }
+    input_log_finish(&in_log, &vm->io, false, machine_counted(vm),
+		     vm->executed);
+    if (!vm->halt) {
+	trace_dump(&vm->trace, stderr);
+    }
+}
+
+/* Print a usage message on stderr 
+   and exit with failure. */
+static void usage(const char *cmdname)
+{
+    fprintf(stderr,
+	    "Usage: %s [-n] [-e switch|checked|threaded|jit] [-F] [-f]"
+	    " [-s height] [-o size] [-O full|line|char] [-p] [-J file]"
+	    " [-P] [-c] [-L fuel] [-t trace-file] [-r steps]"
+	    " [-w log-file] [-i log-file] code-filename\n"
+	    "       %s --batch [-j threads] [-d out-dir] [-s height]"
+	    " [-L fuel] [-e engine] [--count] manifest|directory\n"
+	    "       %s --decode trace-file [code-filename]\n"
+	    "       %s --serve [-e engine] [-s height] [-L fuel]"
+	    " socket|- code-filename\n"
+	    "       %s --request socket\n",
+	    cmdname, cmdname, cmdname, cmdname, cmdname);
+    exit(EXIT_FAILURE);
+}
+
+// Return the amount of fuel in arg (a positive number),
+// or exit with the usage message if it is not one
+static unsigned long fuel_arg(const char *cmdname, const char *arg)
+{
+    char *end;
+    unsigned long fuel = strtoul(arg, &end, 10);
+    if (fuel == 0 || *end != '\0' || arg[0] == '-') {
+	usage(cmdname);
+    }
+    return fuel;
+}
+
+// Return the engine named arg (see vm_api.h),
+// or exit with the usage message if there is no such engine
+static engine_kind engine_arg(const char *cmdname, const char *arg)
+{
+    if (strcmp(arg, "switch") == 0) {
+	return engine_switch;
+    } else if (strcmp(arg, "checked") == 0) {
+	return engine_checked;
+    } else if (strcmp(arg, "threaded") == 0) {
+	return engine_threaded;
+    } else if (strcmp(arg, "jit") == 0 && jit_available()) {
+	return engine_jit;
+    }
+    usage(cmdname);
+    return engine_threaded;
+}
+
+// Run the batch runner (see batch.h) with the options in argv
+// (which has argc elements, after --batch), and exit
+static void batch_main(const char *cmdname, int argc, char *argv[])
+{
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *out_dir = NULL;
+    int height = 0;
+    unsigned long fuel = 0;
+    engine_kind engine = engine_threaded;
+    bool count = false;
+    // possible options: -j threads, -d out-dir, -s height, -L fuel,
+    // -e engine, and --count
+    while (argc > 1 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "--count") == 0) {
+	    count = true;
+	    argc--;
+	    argv++;
+	    continue;
+	}
+	if (argc == 2) {
+	    usage(cmdname);
+	}
+	if (strcmp(argv[0], "-j") == 0) {
+	    threads = atoi(argv[1]);
+	    if (threads <= 0) {
+		usage(cmdname);
+	    }
+	} else if (strcmp(argv[0], "-d") == 0) {
+	    out_dir = argv[1];
+	} else if (strcmp(argv[0], "-s") == 0) {
+	    height = atoi(argv[1]);
+	    if (height <= 0 || height > STACK_CAPACITY) {
+		usage(cmdname);
+	    }
+	} else if (strcmp(argv[0], "-L") == 0) {
+	    fuel = fuel_arg(cmdname, argv[1]);
+	} else if (strcmp(argv[0], "-e") == 0) {
+	    engine = engine_arg(cmdname, argv[1]);
+	} else {
+	    usage(cmdname);
+	}
+	argc -= 2;
+	argv += 2;
+    }
+    if (argc != 1 || argv[0][0] == '-') {
+	usage(cmdname);
+    }
+    exit(batch_run(argv[0], (threads > 0) ? threads : 1, out_dir, height,
+		   fuel, engine, count));
+}
+
+// Run the server (see server.h) with the options in argv
+// (which has argc elements, after --serve), and exit
+static void serve_main(const char *cmdname, int argc, char *argv[])
+{
+    vm = vm_create();
+    if (vm == NULL) {
+	bail_with_error("Not enough space for the VM!");
+    }
+    // possible options: -e engine, -s height, and -L fuel
+    while (argc > 3 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-e") == 0) {
+	    vm_set_engine(vm, engine_arg(cmdname, argv[1]));
+	} else if (strcmp(argv[0], "-s") == 0) {
+	    if (!vm_set_stack_height(vm, atoi(argv[1]))) {
+		usage(cmdname);
+	    }
+	} else if (strcmp(argv[0], "-L") == 0) {
+	    vm_set_fuel(vm, fuel_arg(cmdname, argv[1]));
+	} else {
+	    usage(cmdname);
+	}
+	argc -= 2;
+	argv += 2;
+    }
+    if (argc != 2 || argv[1][0] == '-'
+	|| (argv[0][0] == '-' && strcmp(argv[0], SERVE_PIPE) != 0)) {
+	usage(cmdname);
+    }
+    exit(serve(vm, argv[1], argv[0]));
+}
+
+int main(int argc, char *argv[])
+{
+    const char *cmdname = argv[0];
+    argc--;
+    argv++;
+    if (argc > 0 && strcmp(argv[0], "--batch") == 0) {
+	batch_main(cmdname, argc-1, argv+1);
+    }
+    if (argc > 0 && strcmp(argv[0], "--decode") == 0) {
+	// print a binary trace (see trace.h) as text
+	if (argc != 2 && argc != 3) {
+	    usage(cmdname);
+	}
+	return trace_decode(argv[1], (argc == 3) ? argv[2] : NULL);
+    }
+    if (argc > 0 && strcmp(argv[0], "--serve") == 0) {
+	serve_main(cmdname, argc-1, argv+1);
+    }
+    if (argc > 0 && strcmp(argv[0], "--request") == 0) {
+	// send the standard input to a server, printing its reply
+	if (argc != 2) {
+	    usage(cmdname);
+	}
+	return serve_request(argv[1]);
+    }
+    vm = vm_create();
+    if (vm == NULL) {
+	bail_with_error("Not enough space for the VM!");
+    }
+    input_log_create(&in_log);
+    // default is to print the program and do tracing
+    vm->tracing = true;
+    // possible options: -n, -e engine, -F, -f, -s height, -o size,
+    // -O policy, -p, -J file, -P, -c, -L fuel, -t trace-file,
+    // -r steps, -w log-file, and -i log-file
+    while (argc > 1 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-n") == 0) {
+	    // -n turns off tracing
+	    vm->tracing = false;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-e") == 0) {
+	    // -e names the engine used when not tracing
+	    vm->engine = engine_arg(cmdname, argv[1]);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-F") == 0) {
+	    // -F turns off the fusion of instructions
+	    vm->fusing = false;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-f") == 0) {
+	    // -f prints statistics about fused instructions
+	    vm->fusion_stats = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-s") == 0) {
+	    // -s sets the maximum height of the stack
+	    int height = atoi(argv[1]);
+	    if (height <= 0 || height > STACK_CAPACITY) {
+		usage(cmdname);
+	    }
+	    stack_set_max_height(&vm->stack, height);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-o") == 0) {
+	    // -o sets the size of the output buffer
+	    int size = atoi(argv[1]);
+	    if (size <= 0) {
+		usage(cmdname);
+	    }
+	    char_io_set_buffer_size(&vm->io, size);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-O") == 0) {
+	    // -O sets when the output buffer is flushed
+	    if (strcmp(argv[1], "full") == 0) {
+		char_io_set_flush_policy(&vm->io, flush_when_full);
+	    } else if (strcmp(argv[1], "line") == 0) {
+		char_io_set_flush_policy(&vm->io, flush_each_line);
+	    } else if (strcmp(argv[1], "char") == 0) {
+		char_io_set_flush_policy(&vm->io, flush_each_char);
+	    } else {
+		usage(cmdname);
+	    }
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-p") == 0) {
+	    // -p turns on the profiler (see profile.h); instructions are
+	    // not fused, so each is counted at its own address
+	    vm->profiling = true;
+	    vm->fusing = false;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-J") == 0) {
+	    // -J also writes the profile as JSON to the named file
+	    vm->profiling = true;
+	    vm->fusing = false;
+	    profile_set_json_file(&vm->profile, argv[1]);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-P") == 0) {
+	    // -P reports the hardware counters (or the times) of the run,
+	    // with the VM's counts (see counters.h)
+	    vm->measuring = true;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-c") == 0) {
+	    // -c counts every instruction executed; as with -p, they are
+	    // not fused, and run in the checked engine (or the switch one)
+	    vm->counting = true;
+	    vm->fusing = false;
+	    argc--;
+	    argv++;
+	} else if (strcmp(argv[0], "-L") == 0) {
+	    // -L limits the calls and backward jumps the program can make
+	    machine_set_fuel(vm, fuel_arg(cmdname, argv[1]));
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-t") == 0) {
+	    // -t records the trace in binary in the named file
+	    // (see trace.h) instead of printing it
+	    trace_set_file(&vm->trace, argv[1]);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-r") == 0) {
+	    // -r records the trace in binary (in memory, without -t),
+	    // printing the last steps if an error stops the program
+	    int steps = atoi(argv[1]);
+	    if (steps <= 0) {
+		usage(cmdname);
+	    }
+	    trace_set_dump_steps(&vm->trace, steps);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-w") == 0) {
+	    // -w records the program's input in the named log file
+	    input_log_record(&in_log, &vm->io, argv[1]);
+	    argc -= 2;
+	    argv += 2;
+	} else if (strcmp(argv[0], "-i") == 0) {
+	    // -i replays the input recorded in the named log file
+	    input_log_replay(&in_log, &vm->io, argv[1]);
+	    argc -= 2;
+	    argv += 2;
+	} else {
+	    usage(cmdname);
+	}
+    }
+    
+    /* process file name argument */
+    if (argc != 1 || argv[0][0] == '-') {
+	    usage(cmdname);
+    }
+    // errors exit, first writing out the program's output
+    error_io_current = &vm->io;
+    atexit(finish_at_exit);
+    machine(vm, argv[0]);
+    input_log_finish(&in_log, &vm->io, true, machine_counted(vm),
+		     vm->executed);
+    return EXIT_SUCCESS;
+}
@@ -1,14 +1,23 @@
-/* $Id: machine_types.h,v 1.3 2023/03/20 17:13:53 leavens Exp $ */
-#ifndef _MACHINE_TYPES_H
-#define _MACHINE_TYPES_H
-
-// words for this machine
-typedef short int word;
-
-// addresses for this machine
-typedef unsigned short int address;
-
-// number of words used by call instruction
-#define LINKS_SIZE 3
-
-#endif
+/* $Id: machine_types.h,v 1.3 2023/03/20 17:13:53 leavens Exp $ */
+#ifndef _MACHINE_TYPES_H
+#define _MACHINE_TYPES_H
+
+// words for this machine
+typedef short int word;
+
+// addresses for this machine
+typedef unsigned short int address;
+
+// number of words used by call instruction
+#define LINKS_SIZE 3
+
+// number of words used by a call instruction that pushes
+// no static link (CNL): the dynamic link and the return address
+#define LINKS_SIZE_NO_STAT_LNK 2
+
+// number of entries in the display: the base (BP) of the most recent
+// frame at each lexical level, for the PDB, SDB, and RDB instructions
+// (level 0 is the main program's frame, which starts at 0)
+#define DISPLAY_SIZE 128
+
+#endif
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include "instruction.h"
+#include "utilities.h"
+#include "profile.h"
+
+// Set up p with no program and no JSON file
+void profile_create(profile_data *p)
+{
+    p->counts = NULL;
+    p->last_pc = -1;
+    p->high_water = 0;
+    p->code = NULL;
+    p->code_size = 0;
+    p->json_filename = NULL;
+    p->finished = false;
+}
+
+// Give back the space used by p's counts
+void profile_destroy(profile_data *p)
+{
+    free(p->counts);
+    p->counts = NULL;
+}
+
+// Also write the report in JSON to the file named filename
+void profile_set_json_file(profile_data *p, const char *filename)
+{
+    p->json_filename = filename;
+}
+
+// Start profiling the program in code
+void profile_start(profile_data *p, instruction code[], int size, int sp)
+{
+    profile_destroy(p);
+    p->code = code;
+    p->code_size = size;
+    p->counts = (unsigned long *) calloc(size+1, sizeof(unsigned long));
+    if (p->counts == NULL) {
+	bail_with_error("Not enough space for the profile's counts!");
+    }
+    p->last_pc = -1;
+    p->high_water = sp;
+    p->finished = false;
+}
+
+// the counts that compare_counts compares by
+static _Thread_local unsigned long *sort_counts;
+
+// Compare the addresses at a and b by their counts (greatest first),
+// then by address
+static int compare_counts(const void *a, const void *b)
+{
+    int pa = *(const int *) a;
+    int pb = *(const int *) b;
+    if (sort_counts[pa] != sort_counts[pb]) {
+	return (sort_counts[pa] < sort_counts[pb]) ? 1 : -1;
+    }
+    return pa - pb;
+}
+
+// Return the percentage that count is of total
+static double percent(unsigned long count, unsigned long total)
+{
+    return (total == 0) ? 0.0 : 100.0 * count / total;
+}
+
+// Requires: out is open for writing
+// Print the report as text on out
+static void print_text(FILE *out, profile_data *p, bool halted,
+		       unsigned long total, unsigned long op_counts[],
+		       int by_count[])
+{
+    if (halted) {
+	fprintf(out, "Profile (halted):\n");
+    } else {
+	fprintf(out, "Profile (stopped by an error at address %d):\n",
+		p->last_pc);
+    }
+    fprintf(out, "  instructions executed: %lu\n", total);
+    fprintf(out, "  stack high-water mark: %d\n", p->high_water);
+    fprintf(out, "  executions by opcode:\n");
+    for (int op = 0; op < NUM_OPCODES; op++) {
+	if (op_counts[op] != 0) {
+	    fprintf(out, "    %s %12lu %6.2f%%\n", mnemonic(op),
+		    op_counts[op], percent(op_counts[op], total));
+	}
+    }
+    fprintf(out, "  most executed addresses:\n");
+    fprintf(out, "    %5s %s %6s %12s\n", "Addr", "OP", "M", "Count");
+    for (int i = 0; i < p->code_size && i < PROFILE_HOT_ADDRESSES; i++) {
+	int pc = by_count[i];
+	if (p->counts[pc] == 0) {
+	    break;
+	}
+	fprintf(out, "    %5d %s %6d %12lu %6.2f%%\n", pc,
+		mnemonic(p->code[pc].op), p->code[pc].m, p->counts[pc],
+		percent(p->counts[pc], total));
+    }
+}
+
+// Requires: out is open for writing
+// Print the report as a JSON object on out
+static void print_json(FILE *out, profile_data *p, bool halted,
+		       unsigned long total, unsigned long op_counts[])
+{
+    fprintf(out, "{\n");
+    fprintf(out, "  \"status\": \"%s\",\n", halted ? "halted" : "error");
+    fprintf(out, "  \"last_pc\": %d,\n", p->last_pc);
+    fprintf(out, "  \"instructions\": %lu,\n", total);
+    fprintf(out, "  \"stack_high_water\": %d,\n", p->high_water);
+    fprintf(out, "  \"opcodes\": {");
+    bool first = true;
+    for (int op = 0; op < NUM_OPCODES; op++) {
+	if (op_counts[op] != 0) {
+	    fprintf(out, "%s\n    \"%s\": %lu", first ? "" : ",",
+		    mnemonic(op), op_counts[op]);
+	    first = false;
+	}
+    }
+    fprintf(out, "\n  },\n");
+    fprintf(out, "  \"addresses\": [");
+    first = true;
+    for (int pc = 0; pc < p->code_size; pc++) {
+	if (p->counts[pc] != 0) {
+	    fprintf(out, "%s\n    {\"pc\": %d, \"op\": \"%s\", \"m\": %d,"
+		    " \"count\": %lu}", first ? "" : ",", pc,
+		    mnemonic(p->code[pc].op), p->code[pc].m, p->counts[pc]);
+	    first = false;
+	}
+    }
+    fprintf(out, "\n  ]\n");
+    fprintf(out, "}\n");
+}
+
+// Write the report (only once)
+void profile_finish(profile_data *p, bool halted, int sp)
+{
+    if (p->finished || p->counts == NULL) {
+	return;
+    }
+    p->finished = true;
+    if (sp > p->high_water) {
+	p->high_water = sp;
+    }
+    unsigned long total = 0;
+    unsigned long op_counts[NUM_OPCODES] = { 0 };
+    for (int pc = 0; pc < p->code_size; pc++) {
+	total += p->counts[pc];
+	op_counts[p->code[pc].op] += p->counts[pc];
+    }
+    int *by_count = (int *) malloc(sizeof(int) * (p->code_size+1));
+    if (by_count == NULL) {
+	fprintf(stderr, "Not enough space for the profile report!\n");
+	return;
+    }
+    for (int pc = 0; pc < p->code_size; pc++) {
+	by_count[pc] = pc;
+    }
+    sort_counts = p->counts;
+    qsort(by_count, p->code_size, sizeof(int), compare_counts);
+    print_text(stderr, p, halted, total, op_counts, by_count);
+    if (p->json_filename != NULL) {
+	FILE *out = fopen(p->json_filename, "w");
+	if (out == NULL) {
+	    perror(p->json_filename);
+	} else {
+	    print_json(out, p, halted, total, op_counts);
+	    if (fclose(out) == EOF) {
+		perror(p->json_filename);
+	    }
+	}
+    }
+    free(by_count);
+}
@@ -0,0 +1,63 @@
+#ifndef _PROFILE_H
+#define _PROFILE_H
+#include <stdbool.h>
+#include "instruction.h"
+
+// The profiler (vm -p) counts how many times the instruction at each
+// address is executed, and records the greatest height of the stack
+// (SP) and the total number of instructions executed.
+// The report (a text summary on stderr and, if asked for, a JSON file)
+// is written when the machine halts or when an error stops it.
+
+// the number of the most executed addresses listed in the text report
+#define PROFILE_HOT_ADDRESSES 20
+
+// the profile of one VM's run
+typedef struct {
+    // execution counts, indexed by address (with one extra element,
+    // for the address just past the end of the code)
+    unsigned long *counts;
+    // the address of the instruction executed last
+    int last_pc;
+    // the greatest value of SP seen so far
+    int high_water;
+    // the program being profiled, with code_size instructions
+    instruction *code;
+    int code_size;
+    // the name of the file to write the JSON report to (or NULL)
+    const char *json_filename;
+    // has the report been written?
+    bool finished;
+} profile_data;
+
+// Count one execution (in the profile p) of the instruction
+// at address pc, which starts with the stack's SP equal to sp
+#define PROFILE_STEP(p, pc, sp)					\
+    do {							\
+	(p)->counts[(pc)]++;					\
+	(p)->last_pc = (pc);					\
+	if ((int) (sp) > (p)->high_water) {			\
+	    (p)->high_water = (sp);				\
+	}							\
+    } while (0)
+
+// Set up p with no program and no JSON file
+extern void profile_create(profile_data *p);
+
+// Give back the space used by p's counts
+extern void profile_destroy(profile_data *p);
+
+// Also write the report in JSON to the file named filename
+extern void profile_set_json_file(profile_data *p, const char *filename);
+
+// Requires: code has size elements (the program)
+// Start profiling the program in code (with all counts 0)
+// with the stack's SP equal to sp
+extern void profile_start(profile_data *p, instruction code[], int size,
+			  int sp);
+
+// Requires: profile_start has been called on p
+// Write the report (only once), saying whether the machine halted
+// normally (otherwise an error stopped it), with SP equal to sp
+extern void profile_finish(profile_data *p, bool halted, int sp);
+#endif
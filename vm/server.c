@@ -0,0 +1,359 @@
+// for S_ISSOCK
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "utilities.h"
+#include "vm_api.h"
+#include "server.h"
+
+// the size of a frame's kind and length
+#define HEADER_SIZE (1 + sizeof(unsigned int))
+
+// how many times (and how many milliseconds apart) a request
+// tries to connect to a server that is not listening yet
+#define CONNECT_TRIES 100
+#define CONNECT_WAIT_MILLIS 20
+
+// a connection being served, with the input of its current request
+// (in_len bytes, with room for in_cap, read up to in_next)
+typedef struct {
+    int in_fd;
+    int out_fd;
+    char *in;
+    size_t in_len;
+    size_t in_cap;
+    size_t in_next;
+} connection;
+
+// Write the size bytes in buf to fd, returning false if that fails
+static bool write_all(int fd, const char *buf, size_t size)
+{
+    while (size > 0) {
+	ssize_t n = write(fd, buf, size);
+	if (n < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (n <= 0) {
+	    return false;
+	}
+	buf += n;
+	size -= n;
+    }
+    return true;
+}
+
+// Read size bytes from fd into buf; return 1 if they were read,
+// 0 if the input ended before the first of them,
+// and -1 if it ended later or reading failed
+static int read_all(int fd, char *buf, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+	ssize_t n = read(fd, buf + done, size - done);
+	if (n < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (n <= 0) {
+	    return (n == 0 && done == 0) ? 0 : -1;
+	}
+	done += n;
+    }
+    return 1;
+}
+
+// Write a frame of the given kind with the size bytes in data to fd,
+// returning false if that fails
+static bool write_frame(int fd, char kind, const char *data, size_t size)
+{
+    char header[HEADER_SIZE];
+    unsigned int len = size;
+    header[0] = kind;
+    memcpy(header + 1, &len, sizeof(len));
+    return write_all(fd, header, HEADER_SIZE) && write_all(fd, data, size);
+}
+
+// Read the start of a frame from fd, setting *kind and *len;
+// return as read_all does
+static int read_header(int fd, char *kind, unsigned int *len)
+{
+    char header[HEADER_SIZE];
+    int r = read_all(fd, header, HEADER_SIZE);
+    if (r > 0) {
+	*kind = header[0];
+	memcpy(len, header + 1, sizeof(*len));
+	if (*len > SERVE_MAX_FRAME) {
+	    return -1;
+	}
+    }
+    return r;
+}
+
+// The VM's read hook: read from the current request's input
+static ssize_t read_request(void *arg, char *buf, size_t size)
+{
+    connection *c = (connection *) arg;
+    size_t n = c->in_len - c->in_next;
+    if (n > size) {
+	n = size;
+    }
+    if (n > 0) {
+	memcpy(buf, c->in + c->in_next, n);
+	c->in_next += n;
+    }
+    return n;
+}
+
+// The VM's write hook: send the output in a SERVE_OUTPUT frame
+static ssize_t write_reply(void *arg, const char *buf, size_t size)
+{
+    connection *c = (connection *) arg;
+    if (size > SERVE_MAX_FRAME) {
+	size = SERVE_MAX_FRAME;
+    }
+    return write_frame(c->out_fd, SERVE_OUTPUT, buf, size) ? size : -1;
+}
+
+// Read the data of a SERVE_INPUT frame of len bytes into c's input,
+// returning false if that fails
+static bool read_input(connection *c, unsigned int len)
+{
+    if (len > c->in_cap) {
+	char *bigger = (char *) realloc(c->in, len);
+	if (bigger == NULL) {
+	    return false;
+	}
+	c->in = bigger;
+	c->in_cap = len;
+    }
+    c->in_len = len;
+    c->in_next = 0;
+    return read_all(c->in_fd, c->in, len) > 0;
+}
+
+// Serve the requests that come over c (until it ends) with vm,
+// whose I/O hooks use c
+static void serve_connection(vm_t *vm, connection *c)
+{
+    for (;;) {
+	char kind;
+	unsigned int len;
+	int r = read_header(c->in_fd, &kind, &len);
+	if (r == 0) {
+	    // the client is done
+	    return;
+	}
+	if (r < 0 || kind != SERVE_INPUT || !read_input(c, len)) {
+	    fprintf(stderr, "Dropping a connection with a malformed"
+		    " request\n");
+	    return;
+	}
+	vm_restart(vm);
+	// errors in the program must not show earlier OS errors
+	errno = 0;
+	bool ok;
+	if (vm_run(vm, 0) == vm_halted) {
+	    ok = write_frame(c->out_fd, SERVE_HALTED, NULL, 0);
+	} else {
+	    const char *message = vm_error_message(vm);
+	    ok = write_frame(c->out_fd, SERVE_FAILED, message,
+			     strlen(message));
+	}
+	if (!ok) {
+	    // the client went away
+	    return;
+	}
+    }
+}
+
+// Return a socket listening on the Unix domain socket named name,
+// replacing any socket of that name
+static int listen_on(const char *name)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(name) >= sizeof(addr.sun_path)) {
+	bail_with_error("The socket name '%s' is too long", name);
+    }
+    strcpy(addr.sun_path, name);
+    struct stat st;
+    if (stat(name, &st) == 0) {
+	if (!S_ISSOCK(st.st_mode)) {
+	    bail_with_error("The file '%s' is not a socket", name);
+	}
+	// left by a server that is gone (or that is replaced)
+	unlink(name);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+	bail_with_error("Cannot create a socket");
+    }
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+	bail_with_error("Cannot bind the socket '%s'", name);
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+	bail_with_error("Cannot listen on the socket '%s'", name);
+    }
+    errno = 0;
+    return fd;
+}
+
+// Serve requests to run vm's program on the socket named socket_name
+// (or on the standard input and output)
+int serve(vm_t *vm, const char *code_filename, const char *socket_name)
+{
+    static connection conn;
+    vm_set_io(vm, read_request, write_reply, &conn);
+    if (!vm_load_file(vm, code_filename)) {
+	errno = 0;
+	bail_with_error("%s", vm_error_message(vm));
+    }
+    if (strcmp(socket_name, SERVE_PIPE) == 0) {
+	conn.in_fd = 0;
+	conn.out_fd = 1;
+	serve_connection(vm, &conn);
+	free(conn.in);
+	return EXIT_SUCCESS;
+    }
+    // a client that goes away must not end the server
+    signal(SIGPIPE, SIG_IGN);
+    int listener = listen_on(socket_name);
+    for (;;) {
+	int fd = accept(listener, NULL, NULL);
+	if (fd < 0) {
+	    if (errno == EINTR || errno == ECONNABORTED) {
+		continue;
+	    }
+	    bail_with_error("Cannot accept a connection on the socket '%s'",
+			    socket_name);
+	}
+	conn.in_fd = fd;
+	conn.out_fd = fd;
+	serve_connection(vm, &conn);
+	close(fd);
+    }
+}
+
+// Return a socket connected to the server listening on the socket
+// named name, waiting for it to start listening if need be
+static int connect_to(const char *name)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(name) >= sizeof(addr.sun_path)) {
+	bail_with_error("The socket name '%s' is too long", name);
+    }
+    strcpy(addr.sun_path, name);
+    for (int i = 1; ; i++) {
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+	    bail_with_error("Cannot create a socket");
+	}
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0) {
+	    errno = 0;
+	    return fd;
+	}
+	int err = errno;
+	close(fd);
+	errno = err;
+	if (i == CONNECT_TRIES
+	    || (errno != ENOENT && errno != ECONNREFUSED)) {
+	    bail_with_error("Cannot connect to the server on the socket '%s'",
+			    name);
+	}
+	struct timespec wait = { 0, CONNECT_WAIT_MILLIS * 1000000L };
+	nanosleep(&wait, NULL);
+    }
+}
+
+// Return all of the standard input, setting *len to its length
+static char *read_stdin(size_t *len)
+{
+    size_t cap = 4096;
+    char *buf = (char *) malloc(cap);
+    *len = 0;
+    for (;;) {
+	if (buf == NULL) {
+	    bail_with_error("Not enough space for the request's input!");
+	}
+	ssize_t n = read(0, buf + *len, cap - *len);
+	if (n < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (n < 0) {
+	    bail_with_error("Cannot read the request's input");
+	}
+	if (n == 0) {
+	    return buf;
+	}
+	*len += n;
+	if (*len == cap) {
+	    cap *= 2;
+	    char *bigger = (char *) realloc(buf, cap);
+	    if (bigger == NULL) {
+		free(buf);
+	    }
+	    buf = bigger;
+	}
+    }
+}
+
+// Send the standard input as a request to the server on the socket
+// named socket_name, printing its reply as the vm program would
+int serve_request(const char *socket_name)
+{
+    size_t len;
+    char *input = read_stdin(&len);
+    if (len > SERVE_MAX_FRAME) {
+	bail_with_error("The request's input is too long"
+			" (more than %u bytes)", SERVE_MAX_FRAME);
+    }
+    int fd = connect_to(socket_name);
+    if (!write_frame(fd, SERVE_INPUT, input, len)) {
+	bail_with_error("Cannot send the request to the server");
+    }
+    free(input);
+    char *data = NULL;
+    for (;;) {
+	char kind;
+	unsigned int n;
+	if (read_header(fd, &kind, &n) <= 0) {
+	    errno = 0;
+	    bail_with_error("The server did not reply to the request");
+	}
+	data = (char *) realloc(data, n + 1);
+	if (data == NULL) {
+	    bail_with_error("Not enough space for the server's reply!");
+	}
+	if (n > 0 && read_all(fd, data, n) <= 0) {
+	    errno = 0;
+	    bail_with_error("The server did not reply to the request");
+	}
+	data[n] = '\0';
+	if (kind == SERVE_OUTPUT) {
+	    if (!write_all(1, data, n)) {
+		bail_with_error("Cannot write the program's output");
+	    }
+	} else if (kind == SERVE_HALTED || kind == SERVE_FAILED) {
+	    if (kind == SERVE_FAILED) {
+		fprintf(stderr, "%s\n", data);
+	    }
+	    free(data);
+	    close(fd);
+	    return (kind == SERVE_HALTED) ? EXIT_SUCCESS : EXIT_FAILURE;
+	} else {
+	    errno = 0;
+	    bail_with_error("The server's reply is malformed");
+	}
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef _SERVER_H
+#define _SERVER_H
+#include "vm_api.h"
+
+// The server (vm --serve) loads one program once, and then runs it
+// for each request it gets, each time with the request's input,
+// so that neither starting a process nor reading, checking,
+// and compiling the program is paid for each run.
+// After the program is loaded, the VM is kept as it is then
+// (its snapshot); each request is run from that state (see vm_restart),
+// so no run can see what an earlier one did.
+//
+// Requests come over a Unix domain socket, which the server listens on
+// (one connection at a time; a connection can make any number of
+// requests, one after the other), or over a pipe: the standard input
+// and output, to serve the process that started the server.
+// A request and its reply are made of frames: a frame is its kind
+// (one character), the length of its data (4 bytes, as an unsigned int
+// in the host's byte order, as both ends are on the same machine),
+// then its data. A request is one SERVE_INPUT frame, with all the input
+// the program's CHI instructions read. Its reply is any number of
+// SERVE_OUTPUT frames, with what the program's CHO instructions wrote,
+// then one SERVE_HALTED frame (with no data) if the program halted,
+// or one SERVE_FAILED frame with the error message (without a newline)
+// that the vm program would print.
+
+// the kinds of frames
+#define SERVE_INPUT 'I'
+#define SERVE_OUTPUT 'O'
+#define SERVE_HALTED 'H'
+#define SERVE_FAILED 'F'
+
+// the most data a frame can have
+#define SERVE_MAX_FRAME (1u << 30)
+
+// the name given instead of a socket's to serve over a pipe
+#define SERVE_PIPE "-"
+
+// Requires: no program has been loaded into vm
+// Load the program in the file named code_filename into vm
+// (as vm_load_file does, bailing with its message if that fails),
+// then serve requests to run it on the Unix domain socket named
+// socket_name (replacing any socket of that name), forever,
+// or on the standard input and output, if socket_name is SERVE_PIPE,
+// until the end of the input, and then return EXIT_SUCCESS.
+extern int serve(vm_t *vm, const char *code_filename,
+		 const char *socket_name);
+
+// Send the standard input as a request to the server listening
+// on the socket named socket_name (waiting briefly for it to start),
+// writing the program's output on the standard output and its error
+// message (if it fails) on the standard error output, as the vm program
+// does; return EXIT_SUCCESS if the program halted, and EXIT_FAILURE
+// otherwise.
+extern int serve_request(const char *socket_name);
+#endif
@@ -1,219 +1,289 @@
-/* $Id: stack.c,v 1.14 2023/03/20 17:13:53 leavens Exp $ */
-#include <stdlib.h>
-#include "utilities.h"
-#include "stack.h"
-
-// the stack's storage
-static word stack[MAX_STACK_HEIGHT];
-
-// index of next free element
-static address sp;
-
-// first index of current AR
-static address bp;
-
-// Does the stack's invariant hold?
-// (Exit with an error message if not)
-static void stack_invariant() {
-    if (!(0 <= bp)) {
-	fprintf(stderr, "VM stack invariant failure: BP (%d) < 0!\n",
-		bp);
-    } else if (!(bp <= sp)) {
-	fprintf(stderr, "VM stack invariant failure: SP (%d) < BP (%d)!\n",
-		sp, bp);
-    } else if (!(0 <= sp)) {
-	fprintf(stderr, "VM stack invariant failure: SP (%d) < 0!\n",
-		sp);
-    } else if (!(sp < MAX_STACK_HEIGHT)) {
-	fprintf(stderr, "VM stack invariant failure: MAX_STACK_HEIGHT (%d) <= SP (%d)!\n",
-		MAX_STACK_HEIGHT, sp);
-    } else {
-	return; // the invariant holds
-    }
-    exit(EXIT_FAILURE);
-}
-
-// Initialize the stack data structure
-void stack_initialize()
-{
-    sp = 0;
-    bp = 0;
-    for (address i = 0; i < MAX_STACK_HEIGHT; i++) {
-	stack[i] = 0;
-    }
-    stack_invariant();
-}
-
-// Is the given address legal for the stack?
-static bool legal_stack_index(address addr)
-{
-    return 0 <= addr && addr < MAX_STACK_HEIGHT;
-}
-
-// Return the stack's num. of elements
-// (SP value)
-address stack_size() { return sp; }
-
-// Return the address of the base
-// of the current AR (BP value)
-address stack_AR_base() { return bp; }
-
-// Is the stack empty?
-bool stack_empty() { return sp == 0; }
-
-// Is the stack full?
-bool stack_full() {
-    return sp == MAX_STACK_HEIGHT-1;
-}
-
-// Requires: !stack_full()
-// push a word on the stack
-void stack_push(word val) {
-    if (stack_full()) {
-	bail_with_error(
-          "Trying to push on a full stack!\n");
-    }
-    stack[sp] = val;  // or stack[sp++] = val;
-    sp += 1;
-    stack_invariant();
-}
-
-// Requires: stack_size() + n
-//                  < MAX_STACK_HEIGHT
-// Increase the size of the stack by n
-void stack_allocate(unsigned int n)
-{
-    int new_sp = sp + n;
-    if (!legal_stack_index(new_sp)) {
-	bail_with_error("Can't increase stack size to %d in stack_allocate",
-			new_sp);
-    }
-    sp = new_sp;
-    stack_invariant();
-}
-
-// Requires: !stack_empty()
-// pop the stack and return the top elem
-word stack_pop() {
-    if (stack_empty()) {
-	bail_with_error("Trying to pop an empty stack!");
-	exit(2);
-    } else {    // whole block could be: return stack[sp--];
-	sp = sp-1;
-	return stack[sp];
-    }
-    stack_invariant();
-}
-
-// return the top element without popping
-word stack_top() {
-    if (stack_empty()) {
-	bail_with_error("Trying to pop an empty stack!");
-	exit(2);
-    } else {
-	return stack[sp-1]; // don't use -- here!
-    }
-    stack_invariant();
-}
-
-// fetch the value from the given address
-word stack_fetch(address addr)
-{
-    if (!legal_stack_index(addr)) {
-	bail_with_error("Illegal stack index in stack_fetch: %d", addr);
-    }
-    return stack[addr];
-}
-
-// assign val to the given address, addr, on the stack
-void stack_assign(address addr, word val)
-{
-    if (!legal_stack_index(addr)) {
-	bail_with_error("Illegal stack index in stack_assign: %d", addr);
-    }
-    stack[addr] = val;
-}
-
-// Requires: stack_size()+2
-//                  < MAX_STACK_HEIGHT
-// call a subroutine
-// without any static link
-void stack_call_no_stat_lnk(int ret_addr)
-{
-    // Assume parameters are on top of stack
-    int old_bp = bp;
-    int old_sp = sp;
-    stack_push(old_bp); // dynamic link
-    stack_push(ret_addr);
-    bp = old_sp; // base of the new AR
-    stack_invariant();
-}
-
-// Requires: stack_size()+LINKS_SIZE
-//                  < MAX_STACK_HEIGHT
-// call a subroutine pushing the static link (at bp)
-void stack_call(int ret_addr)
-{
-    // not dealing with parameters
-    int old_bp = bp;
-    int old_sp = sp;
-    stack_push(stack_fetch(old_bp)); // static link
-    stack_push(old_bp); // dynamic link
-    stack_push(ret_addr);
-    bp = old_sp; // base of the new AR
-}
-
-// Requires: saved BP and SP values
-//           will satisfy stack's invariant
-// return (with no result) from subroutine;
-// this assumes there is no static link
-void stack_return_no_stat_lnk(int *PC)
-{
-    // restore PC
-    *PC = stack_pop();
-    // restore BP
-    bp = stack_pop();
-    stack_invariant();
-}
-
-// Requires: saved BP and SP values
-//           will satisfy stack's invariant
-// return (with no result) from subroutine
-void stack_return(int *PC)
-{
-    // restore PC
-    *PC = stack_pop();
-    // restore BP
-    bp = stack_pop();
-    // toss the old static link
-    stack_pop();
-    stack_invariant();
-}
-
-// Return from a subroutine
-// (with a static link saved)
-// and push the given return value
-void stack_return_value(int *PC,
-                        word fun_value)
-{
-    // restore PC
-    *PC = stack_pop();
-    // restore BP
-    bp = stack_pop();
-    // toss the old static link
-    stack_pop();
-    // push the function's value
-    stack_push(fun_value);
-    stack_invariant();
-}
-
-// print the stack's values in the current AR
-// (between stack_base() and stack_size()-1)
-void stack_print(FILE *out)
-{
-    for (address a = bp; a < MAX_STACK_HEIGHT && a < sp; a++) {
-	fprintf(out, "S[%d]: %d ", a, stack[a]);
-    }
-    fprintf(out, "\n");
-
-}
+/* $Id: stack.c,v 1.14 2023/03/20 17:13:53 leavens Exp $ */
+// for MAP_ANONYMOUS, MAP_NORESERVE, and madvise
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "utilities.h"
+#include "stack.h"
+
+// Does the stack's invariant hold?
+// (Exit with an error message if not)
+static void stack_invariant(vm_stack *s) {
+    if (!(0 <= s->bp)) {
+	exit_with_error("VM stack invariant failure: BP (%d) < 0!",
+			s->bp);
+    } else if (!(s->bp <= s->sp)) {
+	exit_with_error("VM stack invariant failure: SP (%d) < BP (%d)!",
+			s->sp, s->bp);
+    } else if (!(0 <= s->sp)) {
+	exit_with_error("VM stack invariant failure: SP (%d) < 0!",
+			s->sp);
+    } else if (!(s->sp < s->max_height)) {
+	exit_with_error("VM stack invariant failure: maximum height (%d) <= SP (%d)!",
+			s->max_height, s->sp);
+    }
+}
+
+// Set up s as an empty stack without storage
+void stack_create(vm_stack *s)
+{
+    s->storage = NULL;
+    s->max_height = STACK_DEFAULT_HEIGHT;
+    s->sp = 0;
+    s->bp = 0;
+}
+
+// Requires: 0 < height <= STACK_CAPACITY
+// Set the maximum height of the stack
+void stack_set_max_height(vm_stack *s, int height)
+{
+    s->max_height = height;
+}
+
+// Return the maximum height of the stack
+int stack_max_height(vm_stack *s) { return s->max_height; }
+
+// Return the size of the stack's storage, in bytes
+static size_t storage_size()
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    return (STACK_CAPACITY * sizeof(word) + page - 1) / page * page;
+}
+
+// Map (or, if it is already mapped, clear) the stack's storage.
+// The storage is reserved without committing memory, so the OS only
+// supplies (zeroed) pages as they are touched, and the page after it
+// is made inaccessible to catch an interpreter running off the end.
+static void stack_map(vm_stack *s)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t size = storage_size();
+    if (s->storage != NULL) {
+	// give the used pages back, so they read as zeros again
+	if (madvise(s->storage, size, MADV_DONTNEED) != 0) {
+	    bail_with_error("Cannot clear the stack");
+	}
+	return;
+    }
+    // the storage, then the guard page
+    void *mem = mmap(NULL, size + page, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) {
+	bail_with_error("Cannot reserve space for the stack");
+    }
+    if (mprotect((char *) mem + size, page, PROT_NONE) != 0) {
+	bail_with_error("Cannot protect the stack's guard page");
+    }
+    s->storage = mem;
+}
+
+// Initialize the stack data structure
+void stack_initialize(vm_stack *s)
+{
+    stack_map(s);
+    s->sp = 0;
+    s->bp = 0;
+    stack_invariant(s);
+}
+
+// Give back the storage of s (and its guard page)
+void stack_destroy(vm_stack *s)
+{
+    if (s->storage != NULL) {
+	munmap(s->storage, storage_size() + sysconf(_SC_PAGESIZE));
+	s->storage = NULL;
+    }
+}
+
+// Is the given address legal for the stack?
+static bool legal_stack_index(vm_stack *s, address addr)
+{
+    return addr < s->max_height;
+}
+
+// Return the stack's num. of elements
+// (SP value)
+address stack_size(vm_stack *s) { return s->sp; }
+
+// Return the address of the base
+// of the current AR (BP value)
+address stack_AR_base(vm_stack *s) { return s->bp; }
+
+// Is the stack empty?
+bool stack_empty(vm_stack *s) { return s->sp == 0; }
+
+// Is the stack full?
+bool stack_full(vm_stack *s) {
+    return s->sp == s->max_height-1;
+}
+
+// Requires: !stack_full()
+// push a word on the stack
+void stack_push(vm_stack *s, word val) {
+    if (stack_full(s)) {
+	bail_with_error(
+          "Trying to push on a full stack!\n");
+    }
+    s->storage[s->sp] = val;  // or stack[sp++] = val;
+    s->sp += 1;
+    stack_invariant(s);
+}
+
+// Requires: stack_size() + n
+//                  < stack_max_height()
+// Increase the size of the stack by n
+void stack_allocate(vm_stack *s, unsigned int n)
+{
+    int new_sp = s->sp + n;
+    if (new_sp < 0 || new_sp >= s->max_height) {
+	bail_with_error("Can't increase stack size to %d in stack_allocate",
+			new_sp);
+    }
+    s->sp = new_sp;
+    stack_invariant(s);
+}
+
+// Requires: !stack_empty()
+// pop the stack and return the top elem
+word stack_pop(vm_stack *s) {
+    if (stack_empty(s)) {
+	bail_with_error("Trying to pop an empty stack!");
+	exit(2);
+    } else {    // whole block could be: return stack[sp--];
+	s->sp = s->sp-1;
+	return s->storage[s->sp];
+    }
+    stack_invariant(s);
+}
+
+// return the top element without popping
+word stack_top(vm_stack *s) {
+    if (stack_empty(s)) {
+	bail_with_error("Trying to pop an empty stack!");
+	exit(2);
+    } else {
+	return s->storage[s->sp-1]; // don't use -- here!
+    }
+    stack_invariant(s);
+}
+
+// fetch the value from the given address
+word stack_fetch(vm_stack *s, address addr)
+{
+    if (!legal_stack_index(s, addr)) {
+	bail_with_error("Illegal stack index in stack_fetch: %d", addr);
+    }
+    return s->storage[addr];
+}
+
+// assign val to the given address, addr, on the stack
+void stack_assign(vm_stack *s, address addr, word val)
+{
+    if (!legal_stack_index(s, addr)) {
+	bail_with_error("Illegal stack index in stack_assign: %d", addr);
+    }
+    s->storage[addr] = val;
+}
+
+// Requires: stack_size()+2
+//                  < stack_max_height()
+// call a subroutine
+// without any static link
+void stack_call_no_stat_lnk(vm_stack *s, int ret_addr)
+{
+    // Assume parameters are on top of stack
+    int old_bp = s->bp;
+    int old_sp = s->sp;
+    stack_push(s, old_bp); // dynamic link
+    stack_push(s, ret_addr);
+    s->bp = old_sp; // base of the new AR
+    stack_invariant(s);
+}
+
+// Requires: stack_size()+LINKS_SIZE
+//                  < stack_max_height()
+// call a subroutine pushing the static link (at bp)
+void stack_call(vm_stack *s, int ret_addr)
+{
+    // not dealing with parameters
+    int old_bp = s->bp;
+    int old_sp = s->sp;
+    stack_push(s, stack_fetch(s, old_bp)); // static link
+    stack_push(s, old_bp); // dynamic link
+    stack_push(s, ret_addr);
+    s->bp = old_sp; // base of the new AR
+}
+
+// Requires: saved BP and SP values
+//           will satisfy stack's invariant
+// return (with no result) from subroutine;
+// this assumes there is no static link
+void stack_return_no_stat_lnk(vm_stack *s, int *PC)
+{
+    // restore PC
+    *PC = stack_pop(s);
+    // restore BP
+    s->bp = stack_pop(s);
+    stack_invariant(s);
+}
+
+// Requires: saved BP and SP values
+//           will satisfy stack's invariant
+// return (with no result) from subroutine
+void stack_return(vm_stack *s, int *PC)
+{
+    // restore PC
+    *PC = stack_pop(s);
+    // restore BP
+    s->bp = stack_pop(s);
+    // toss the old static link
+    stack_pop(s);
+    stack_invariant(s);
+}
+
+// Return from a subroutine
+// (with a static link saved)
+// and push the given return value
+void stack_return_value(vm_stack *s, int *PC,
+                        word fun_value)
+{
+    // restore PC
+    *PC = stack_pop(s);
+    // restore BP
+    s->bp = stack_pop(s);
+    // toss the old static link
+    stack_pop(s);
+    // push the function's value
+    stack_push(s, fun_value);
+    stack_invariant(s);
+}
+
+// Return the stack's storage (STACK_CAPACITY words, followed by
+// a page that cannot be accessed),
+// for an interpreter that does its own checks (see verifier.h)
+word *stack_storage(vm_stack *s)
+{
+    return s->storage;
+}
+
+// Requires: 0 <= new_bp <= new_sp < stack_max_height()
+// Set the SP and BP registers (after running such an interpreter)
+void stack_set_registers(vm_stack *s, address new_sp,
+			 address new_bp)
+{
+    s->sp = new_sp;
+    s->bp = new_bp;
+    stack_invariant(s);
+}
+
+// print the stack's values in the current AR
+// (between stack_base() and stack_size()-1)
+void stack_print(vm_stack *s, FILE *out)
+{
+    for (address a = s->bp; a < s->max_height && a < s->sp; a++) {
+	fprintf(out, "S[%d]: %d ", a, s->storage[a]);
+    }
+    fprintf(out, "\n");
+
+}
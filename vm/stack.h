@@ -1,66 +1,113 @@
-/* $Id: stack.h,v 1.11 2023/03/20 17:13:53 leavens Exp $ */
-#ifndef _STACK_H
-#define _STACK_H
-#include <stdbool.h>
-#include <stdio.h>
-#include "machine_types.h"
-
-#define MAX_STACK_HEIGHT 2048
-
-// Initialize the stack data structure
-extern void stack_initialize();
-
-// Return the stack's num. of elements (SP value)
-extern address stack_size();
-
-// Return the address of the base
-// of the current AR (BP value)
-extern address stack_AR_base();
-
-// Is the stack empty?
-extern bool stack_empty();
-
-// Is the stack full?
-extern bool stack_full();
-
-// push a word on the stack
-extern void stack_push(word val);
-
-// Increase the size of the stack by n
-void stack_allocate(unsigned int n);
-
-// pop the stack and return the top elem
-extern word stack_pop();
-
-// return the top element without popping
-extern word stack_top();
-
-// fetch the value from the given address
-extern word stack_fetch(address addr);
-
-// assign val to the given address, addr, on the stack
-extern void stack_assign(address addr, word val);
-
-// call a subroutine
-// without any static link
-void stack_call_no_stat_lnk(int ret_addr);
-
-// call a subroutine
-extern void stack_call(int ret_addr);
-
-// return (with no result) from subroutine
-// this assumes there is no static link
-void stack_return_no_stat_lnk(int *PC);
-
-// return (with no result) from subroutine
-extern void stack_return(int *PC);
-
-// return given value from a subroutine
-extern void stack_return_value(
-	        int *PC,
-   	        word fun_value);
-
-// print the stack's values in the current AR
-// (between stack_base() and stack_size()-1)
-extern void stack_print(FILE *out);
-#endif
+/* $Id: stack.h,v 1.11 2023/03/20 17:13:53 leavens Exp $ */
+#ifndef _STACK_H
+#define _STACK_H
+#include <stdbool.h>
+#include <stdio.h>
+#include "machine_types.h"
+
+// the number of words reserved for the stack, which is every address
+// (only the pages that are used are given memory by the OS)
+#define STACK_CAPACITY 65536
+
+// the maximum height of the stack unless it is set (see
+// stack_set_max_height): the addresses below it are those that are
+// not negative as 16-bit offsets, so an address that wrapped around
+// (such as a negative offset from BP) is still an illegal index
+#define STACK_DEFAULT_HEIGHT 32768
+
+// a VM's stack; each VM has its own, and its fields
+// are only used by the functions below
+typedef struct {
+    // the stack's storage (STACK_CAPACITY words), or NULL before it is mapped
+    word *storage;
+    // the maximum height of the stack
+    int max_height;
+    // index of next free element
+    address sp;
+    // first index of current AR
+    address bp;
+} vm_stack;
+
+// Set up s as an empty stack with the maximum height STACK_DEFAULT_HEIGHT,
+// without any storage yet
+extern void stack_create(vm_stack *s);
+
+// Give back the storage of s
+extern void stack_destroy(vm_stack *s);
+
+// Requires: 0 < height <= STACK_CAPACITY
+// Set the maximum height of the stack (STACK_DEFAULT_HEIGHT by default,
+// which can be raised to use all of the storage);
+// addresses at or above it are illegal
+extern void stack_set_max_height(vm_stack *s, int height);
+
+// Return the maximum height of the stack
+extern int stack_max_height(vm_stack *s);
+
+// Initialize the stack data structure
+extern void stack_initialize(vm_stack *s);
+
+// Return the stack's num. of elements (SP value)
+extern address stack_size(vm_stack *s);
+
+// Return the address of the base
+// of the current AR (BP value)
+extern address stack_AR_base(vm_stack *s);
+
+// Is the stack empty?
+extern bool stack_empty(vm_stack *s);
+
+// Is the stack full?
+extern bool stack_full(vm_stack *s);
+
+// push a word on the stack
+extern void stack_push(vm_stack *s, word val);
+
+// Increase the size of the stack by n
+void stack_allocate(vm_stack *s, unsigned int n);
+
+// pop the stack and return the top elem
+extern word stack_pop(vm_stack *s);
+
+// return the top element without popping
+extern word stack_top(vm_stack *s);
+
+// fetch the value from the given address
+extern word stack_fetch(vm_stack *s, address addr);
+
+// assign val to the given address, addr, on the stack
+extern void stack_assign(vm_stack *s, address addr, word val);
+
+// call a subroutine
+// without any static link
+void stack_call_no_stat_lnk(vm_stack *s, int ret_addr);
+
+// call a subroutine
+extern void stack_call(vm_stack *s, int ret_addr);
+
+// return (with no result) from subroutine
+// this assumes there is no static link
+void stack_return_no_stat_lnk(vm_stack *s, int *PC);
+
+// return (with no result) from subroutine
+extern void stack_return(vm_stack *s, int *PC);
+
+// return given value from a subroutine
+extern void stack_return_value(vm_stack *s,
+	        int *PC,
+   	        word fun_value);
+
+// Return the stack's storage (STACK_CAPACITY words, followed by
+// a page that cannot be accessed),
+// for an interpreter that does its own checks (see verifier.h)
+extern word *stack_storage(vm_stack *s);
+
+// Requires: 0 <= new_bp <= new_sp < stack_max_height(s)
+// Set the SP and BP registers (after running such an interpreter)
+extern void stack_set_registers(vm_stack *s, address new_sp,
+				address new_bp);
+
+// print the stack's values in the current AR
+// (between stack_base() and stack_size()-1)
+extern void stack_print(vm_stack *s, FILE *out);
+#endif
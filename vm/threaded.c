@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "instruction.h"
+#include "utilities.h"
+#include "stack.h"
+#include "machine.h"
+#include "verifier.h"
+#include "fusion.h"
+#include "char_io.h"
+#include "profile.h"
+#include "threaded.h"
+
+// GCC and clang support taking the address of a label (&&label)
+// and jumping to it (goto *p), which lets each handler
+// jump directly to the next one.
+// Define NO_COMPUTED_GOTO to use the portable switch instead.
+#if defined(__GNUC__) && !defined(NO_COMPUTED_GOTO)
+#define COMPUTED_GOTO
+#endif
+
+// an instruction in threaded form
+typedef struct thread_cell {
+#ifdef COMPUTED_GOTO
+    const void *handler; // address of the code that executes it
+#else
+    int op; // opcode
+#endif
+    int m; // M
+    int n; // second operand of a fused instruction
+} thread_cell;
+
+// Go on to the instruction at pc (after STEP, which each engine defines)
+#ifdef COMPUTED_GOTO
+#define OP(name) L_##name
+#define NEXT() do { STEP(); goto *cells[pc].handler; } while (0)
+#else
+#define OP(name) case name
+#define NEXT() do { STEP(); goto dispatch; } while (0)
+#endif
+
+// Define STACK_ACCESS_STATS to count the loads and stores
+// of the stack's storage made by the unchecked engines
+// (and print the counts when threaded_run returns).
+#ifdef STACK_ACCESS_STATS
+static unsigned long stack_loads = 0;
+static unsigned long stack_stores = 0;
+#define LOAD(i) (stack_loads++, stk[i])
+#define STORE(i, v) (stack_stores++, stk[i] = (v))
+#else
+#define LOAD(i) (stk[i])
+#define STORE(i, v) (stk[i] = (v))
+#endif
+
+// Report an illegal stack address in the given operation, like the
+// stack module does, and exit; this does not return.
+static word illegal_index(const char *operation, address addr)
+{
+    bail_with_error("Illegal stack index in %s: %d", operation, addr);
+    return 0;
+}
+
+// the engine that checks every stack operation
+#define ENGINE_NAME run_checked
+#include "threaded_engine.h"
+#undef ENGINE_NAME
+
+// the engine for verified programs
+#define ENGINE_NAME run_unchecked
+#define UNCHECKED
+#include "threaded_engine.h"
+#undef UNCHECKED
+#undef ENGINE_NAME
+
+// the checked engine for unfused code, counting the executions
+// of each instruction and the budget
+#define ENGINE_NAME run_stepped
+#define STEPPED
+#include "threaded_engine.h"
+#undef STEPPED
+#undef ENGINE_NAME
+
+// the checked engine, counting the executions of fused instructions
+#define ENGINE_NAME run_counting
+#define COUNT_FUSIONS
+#include "threaded_engine.h"
+#undef COUNT_FUSIONS
+#undef ENGINE_NAME
+
+// Run vm's program in the threaded engines, starting at vm->PC,
+// returning true if it halts and false if its budget runs out.
+// If use_verifier is true and the program verifies,
+// run it without checks on each push and pop.
+// If vm->fusion_stats, count the executions of fused instructions.
+// If STEPPING(vm), count each instruction instead (in the checked engine).
+bool threaded_run(vm_t *vm, bool use_verifier)
+{
+    int size = vm->code_size;
+    // the engines' space is kept for later runs of the program
+    if (vm->cells == NULL) {
+	vm->cells = (thread_cell *) malloc(sizeof(thread_cell) * (size+1));
+	if (vm->cells == NULL) {
+	    bail_with_error("Not enough space for the threaded code!");
+	}
+    }
+    bool halted;
+    if (STEPPING(vm)) {
+	halted = run_stepped(vm, &vm->PC);
+    } else if (vm->fusion_stats) {
+	halted = run_counting(vm, &vm->PC);
+    } else if (use_verifier && machine_verify(vm)
+	       // fusion leaves every instruction at its address and
+	       // with its stack height,
+	       // so the verifier can check the original code
+	       && run_unchecked(vm, &vm->PC)) {
+	halted = true;
+    } else {
+	halted = run_checked(vm, &vm->PC);
+    }
+#ifdef STACK_ACCESS_STATS
+    fprintf(stderr, "Stack loads: %lu, stores: %lu\n",
+	    stack_loads, stack_stores);
+#endif
+    return halted;
+}
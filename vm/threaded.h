@@ -0,0 +1,28 @@
+#ifndef _THREADED_H
+#define _THREADED_H
+#include <stdbool.h>
+#include "machine.h"
+
+// Requires: vm's program is loaded (so vm->fused is the result
+//           of fuse_program on vm->code) and 0 <= vm->PC
+// Run vm's program in vm->fused, starting at vm->PC, without tracing
+// until a HLT instruction is executed, then set vm->PC to the
+// address after that HLT and return true.
+// The fused code is first translated into a threaded form
+// (one handler address per instruction), which is then dispatched
+// with computed gotos (or with a switch, if the compiler
+// does not support computed gotos).
+// If use_verifier is true and the program in vm->code verifies
+// (see verifier.h), it runs without checks on each push and pop,
+// falling back to the checked stack operations if a check
+// at a CAL or RTN fails.
+// If vm->fusion_stats is true, the executions of each fused instruction
+// are counted in vm->fusion_hits (and the checked engine is used).
+// If STEPPING(vm) (see machine.h), the unfused program runs
+// in the checked engine, counting each instruction in vm->executed
+// (and its executions in vm->profile, if profiling) and stopping
+// (and returning false, with vm->PC the address of the next instruction)
+// if the budget runs out.
+// Errors are reported exactly as in execute().
+extern bool threaded_run(vm_t *vm, bool use_verifier);
+#endif
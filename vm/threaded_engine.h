@@ -0,0 +1,622 @@
+// This file is included by threaded.c, once for each engine it defines.
+// Before including it, define ENGINE_NAME as the name of the function
+// to define, and define UNCHECKED for the engine that
+// runs verified programs with raw accesses to the stack's storage;
+// otherwise all stack operations go through the (checked) stack module.
+// Define COUNT_FUSIONS to count the executions of fused instructions
+// in vm->fusion_hits, or STEPPED to run the unfused program,
+// counting each instruction in vm->executed, its executions and
+// the stack's high-water mark (see profile.h) if vm->profiling,
+// and each instruction against vm's budget if vm->budget_limited.
+// Every engine uses up vm's fuel at each call and backward jump
+// (see machine_set_fuel), reporting an error when there is none left.
+// The function defined has the form
+//    static bool ENGINE_NAME(vm_t *vm, int *PC)
+// and translates vm's (fused) program into vm->cells
+// (which has room for one more cell than the program has instructions),
+// then runs it from *PC until it halts (returning true),
+// or (only when UNCHECKED) until it can no longer show that
+// it is safe to skip the checks (returning false),
+// or (only when STEPPED) until the budget runs out (returning false);
+// in each case *PC and the stack's registers are up to date
+// when it returns.
+
+#ifdef UNCHECKED
+// the program verifies, so only the checks in CAL and RTN are needed
+#define PUSH(v) STORE(sp++, (v))
+#define POP() LOAD(--sp)
+#define FETCH(a) (((address)(a) < max_height)			\
+		  ? LOAD((address)(a))					\
+		  : illegal_index("stack_fetch", (a)))
+#define ASSIGN(a, v)							\
+    do {								\
+	if ((address)(a) >= max_height) {				\
+	    illegal_index("stack_assign", (a));			\
+	}								\
+	STORE((address)(a), (v));					\
+    } while (0)
+#define ALLOCATE(n) (sp += (n))
+#define SP_VALUE() (sp)
+#define BP_VALUE() (bp)
+#define JUMP_TO(target) (pc = (target))
+// the display's entry for level m (which the verifier checked)
+#define DISPLAY(m) (vm->display[(m)])
+// the value v, which the original code pushed and then popped
+#define LITERAL(v) (v)
+#else
+#define PUSH(v) stack_push(stack, (v))
+#define POP() stack_pop(stack)
+#define FETCH(a) stack_fetch(stack, (a))
+#define ASSIGN(a, v) stack_assign(stack, (a), (v))
+#define ALLOCATE(n) stack_allocate(stack, (n))
+#define SP_VALUE() stack_size(stack)
+#define BP_VALUE() stack_AR_base(stack)
+#define DISPLAY(m) (*machine_display_entry(vm, (m)))
+// Transfer control to target (an address in the code)
+#define JUMP_TO(target)						\
+    do {							\
+	pc = (target);						\
+	if ((unsigned int) pc >= (unsigned int) size) {	\
+	    bail_with_error("PC (%d) is outside the code!", pc);	\
+	}							\
+    } while (0)
+// the value v, which the original code pushed and then popped,
+// passed through the stack so that a full stack is reported as before
+#define LITERAL(v) (stack_push(stack, (v)), stack_pop(stack))
+#endif
+
+#ifdef COUNT_FUSIONS
+#define COUNT(op) (vm->fusion_hits[(op) - NUM_OPCODES]++)
+#else
+#define COUNT(op)
+#endif
+
+// what is done before each instruction is dispatched
+#ifdef STEPPED
+#define STEP()								\
+    do {								\
+	if (vm->budget_limited) {					\
+	    if (vm->budget == 0) {					\
+		goto out_of_budget;					\
+	    }								\
+	    vm->budget--;						\
+	}								\
+	vm->executed++;							\
+	if (vm->profiling) {						\
+	    PROFILE_STEP(&vm->profile, pc, SP_VALUE());			\
+	}								\
+    } while (0)
+#else
+#define STEP()
+#endif
+
+// Use up one unit of fuel at the call or backward jump at address at
+// (the address of the JMP that a fused branch does the work of),
+// with the fuel kept in a local variable while the engine runs
+#define USE_FUEL(at)							\
+    do {								\
+	if (fuel == 0) {						\
+	    fuel_pc = (at);						\
+	    goto out_of_fuel;						\
+	}								\
+	fuel--;								\
+    } while (0)
+
+static bool ENGINE_NAME(vm_t *vm, int *PC)
+{
+    int size = vm->code_size;
+    thread_cell *cells = vm->cells;
+#ifdef UNCHECKED
+    verified_instr *info = vm->info;
+#else
+    vm_stack *stack = &vm->stack;
+#endif
+#ifdef COMPUTED_GOTO
+    // handler addresses, indexed by opcode
+    static const void *handlers[NUM_FUSED_OPCODES] = {
+	&&L_NOP, &&L_LIT, &&L_RTN, &&L_CAL, &&L_POP,
+	&&L_PSI, &&L_LOD, &&L_STO, &&L_INC, &&L_JMP,
+	&&L_JPC, &&L_CHO, &&L_CHI, &&L_HLT, &&L_NDB,
+	&&L_NEG, &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV,
+	&&L_MOD, &&L_EQL, &&L_NEQ, &&L_LSS, &&L_LEQ,
+	&&L_GTR, &&L_GEQ, &&L_PSP, &&L_PBP, &&L_PPC,
+	&&L_JMI, &&L_PDB, &&L_SDB, &&L_RDB, &&L_CNL, &&L_RNL,
+	// fused instructions (see fusion.h)
+	&&L_LDL, &&L_LDO, &&L_STK, &&L_ADI, &&L_SBI,
+	&&L_JPZ, &&L_BNE, &&L_BEQ, &&L_BGE, &&L_BGT,
+	&&L_BLE, &&L_BLT, &&L_LDD
+    };
+#endif
+    // translate the code into threaded form, with one extra cell
+    // past the end of the code that catches execution falling off the end
+    for (int i = 0; i < size; i++) {
+#ifdef STEPPED
+	// each instruction is counted on its own, so none are fused
+	fused_instr f = { vm->code[i].op, vm->code[i].m, 0 };
+#else
+	fused_instr f = vm->fused[i];
+#endif
+	if (f.op < 0 || f.op >= NUM_FUSED_OPCODES) {
+	    bail_with_error("Undefined opcode: %d", f.op);
+	}
+#ifdef COMPUTED_GOTO
+	cells[i].handler = handlers[f.op];
+#else
+	cells[i].op = f.op;
+#endif
+	cells[i].m = f.m;
+	cells[i].n = f.n;
+    }
+#ifdef COMPUTED_GOTO
+    cells[size].handler = &&L_END;
+#else
+    cells[size].op = -1;
+#endif
+
+    // the address of the instruction being executed
+    int pc;
+    // the size of the links RTN or RNL pops
+    int links;
+    // the calls and backward jumps the program may still make,
+    // and where it ran out (see USE_FUEL)
+    unsigned long fuel = vm->fuel;
+    int fuel_pc;
+    JUMP_TO(*PC);
+#ifdef UNCHECKED
+    // cached registers, written back when this returns
+    word *stk = stack_storage(&vm->stack);
+    int sp = stack_size(&vm->stack);
+    int bp = stack_AR_base(&vm->stack);
+    int max_height = stack_max_height(&vm->stack);
+    if (pc >= size || sp - bp != info[pc].height
+	|| bp + info[pc].frame_size >= max_height) {
+	goto fallback;
+    }
+#endif
+    NEXT();
+
+#ifndef COMPUTED_GOTO
+ dispatch:
+    switch (cells[pc].op) {
+#endif
+    OP(NOP):
+	pc++;
+	NEXT();
+    OP(LIT):
+	PUSH(cells[pc].m);
+	pc++;
+	NEXT();
+    OP(RNL):
+	links = LINKS_SIZE_NO_STAT_LNK;
+	goto do_return;
+    OP(RTN):
+	links = LINKS_SIZE;
+    do_return:
+#ifdef UNCHECKED
+	{
+	    // check that the caller's frame is what the verifier expects
+	    // before returning to it
+	    int ret_addr = LOAD(sp-1);
+	    address old_bp = LOAD(sp-2);
+	    int old_sp = sp - links;
+	    if ((unsigned int) ret_addr >= (unsigned int) size
+		|| old_bp > old_sp
+		|| old_sp - old_bp != info[ret_addr].height
+		|| old_bp + info[ret_addr].frame_size >= max_height) {
+		goto fallback;
+	    }
+	    pc = ret_addr;
+	    bp = old_bp;
+	    sp = old_sp;
+	}
+#else
+	// restore old PC
+	if (links == LINKS_SIZE) {
+	    stack_return(stack, PC);
+	} else {
+	    stack_return_no_stat_lnk(stack, PC);
+	}
+	JUMP_TO(*PC);
+#endif
+	NEXT();
+    OP(CAL):
+#ifdef UNCHECKED
+	{
+	    // the one check needed for the callee's whole frame
+	    int callee = cells[pc].m;
+	    if (sp + info[callee].frame_size >= max_height) {
+		goto fallback;
+	    }
+	    USE_FUEL(pc);
+	    STORE(sp, LOAD(bp)); // static link
+	    STORE(sp+1, bp); // dynamic link
+	    STORE(sp+2, pc+1);
+	    bp = sp;
+	    sp += LINKS_SIZE;
+	    pc = callee;
+	}
+#else
+	USE_FUEL(pc);
+	stack_call(stack, pc+1); // save old PC and set static link
+	JUMP_TO(cells[pc].m);
+#endif
+	NEXT();
+    OP(CNL):
+#ifdef UNCHECKED
+	{
+	    int callee = cells[pc].m;
+	    if (sp + info[callee].frame_size >= max_height) {
+		goto fallback;
+	    }
+	    USE_FUEL(pc);
+	    STORE(sp, bp); // dynamic link
+	    STORE(sp+1, pc+1);
+	    bp = sp;
+	    sp += LINKS_SIZE_NO_STAT_LNK;
+	    pc = callee;
+	}
+#else
+	USE_FUEL(pc);
+	stack_call_no_stat_lnk(stack, pc+1); // save old PC
+	JUMP_TO(cells[pc].m);
+#endif
+	NEXT();
+    OP(POP):
+	(void) POP();
+	pc++;
+	NEXT();
+    OP(PSI):
+	{
+	    int addr = POP();
+	    word val = FETCH(addr);
+	    PUSH(val);
+	}
+	pc++;
+	NEXT();
+    OP(LOD):
+	{
+	    address loc = POP() + cells[pc].m;
+	    word val = FETCH(loc);
+	    PUSH(val);
+	}
+	pc++;
+	NEXT();
+    OP(STO):
+	{
+	    word val = POP();
+	    address dest = POP() + cells[pc].m;
+	    ASSIGN(dest, val);
+	}
+	pc++;
+	NEXT();
+    OP(INC):
+	ALLOCATE(cells[pc].m);
+	pc++;
+	NEXT();
+    OP(JMP):
+	if (cells[pc].m <= 0) {
+	    USE_FUEL(pc);
+	}
+	JUMP_TO(pc + cells[pc].m);
+	NEXT();
+    OP(JPC):
+	if (POP() != 0) {
+	    if (cells[pc].m <= 0) {
+		USE_FUEL(pc);
+	    }
+	    JUMP_TO(pc + cells[pc].m);
+	} else {
+	    pc++;
+	}
+	NEXT();
+    OP(CHO):
+	char_io_put(&vm->io, POP());
+	pc++;
+	NEXT();
+    OP(CHI):
+	PUSH(char_io_get(&vm->io));
+	pc++;
+	NEXT();
+    OP(HLT):
+#ifdef UNCHECKED
+	stack_set_registers(&vm->stack, sp, bp);
+#endif
+	vm->fuel = fuel;
+	*PC = pc+1;
+	return true;
+    OP(NDB):
+	vm->tracing = false;
+	pc++;
+	NEXT();
+    OP(NEG):
+	{
+	    word topval = POP();
+	    PUSH(- topval);
+	}
+	pc++;
+	NEXT();
+    OP(ADD):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    PUSH(second + topval);
+	}
+	pc++;
+	NEXT();
+    OP(SUB):
+	{
+	    int topval = POP();
+	    int second = POP();
+	    PUSH(second - topval);
+	}
+	pc++;
+	NEXT();
+    OP(MUL):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    PUSH(second * topval);
+	}
+	pc++;
+	NEXT();
+    OP(DIV):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    if (topval == 0) {
+		bail_with_error("Divisor is zero in DIV instruction!");
+	    }
+	    PUSH(second / topval);
+	}
+	pc++;
+	NEXT();
+    OP(MOD):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    if (topval == 0) {
+		bail_with_error("Modulus is zero in MOD instruction!");
+	    }
+	    PUSH(second % topval);
+	}
+	pc++;
+	NEXT();
+    OP(EQL):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    PUSH(second == topval);
+	}
+	pc++;
+	NEXT();
+    OP(NEQ):
+	{
+	    word topval = POP();
+	    word second = POP();
+	    PUSH(second != topval);
+	}
+	pc++;
+	NEXT();
+    OP(LSS):
+	{
+	    int topval = POP();
+	    int second = POP();
+	    PUSH(second < topval);
+	}
+	pc++;
+	NEXT();
+    OP(LEQ):
+	{
+	    int topval = POP();
+	    int second = POP();
+	    PUSH(second <= topval);
+	}
+	pc++;
+	NEXT();
+    OP(GTR):
+	{
+	    int topval = POP();
+	    int second = POP();
+	    PUSH(second > topval);
+	}
+	pc++;
+	NEXT();
+    OP(GEQ):
+	{
+	    int topval = POP();
+	    int second = POP();
+	    PUSH(second >= topval);
+	}
+	pc++;
+	NEXT();
+    OP(PSP):
+	{
+	    int top = SP_VALUE();
+	    PUSH(top);
+	}
+	pc++;
+	NEXT();
+    OP(PBP):
+	{
+	    int base = BP_VALUE();
+	    PUSH(base);
+	}
+	pc++;
+	NEXT();
+    OP(PPC):
+	PUSH(pc+1);
+	pc++;
+	NEXT();
+    OP(JMI):
+	JUMP_TO(POP());
+	NEXT();
+    OP(PDB):
+	{
+	    int base = DISPLAY(cells[pc].m);
+	    PUSH(base);
+	}
+	pc++;
+	NEXT();
+    OP(SDB):
+	{
+	    // the static link's place in the frame keeps the old entry
+	    int base = BP_VALUE();
+	    ASSIGN(base, DISPLAY(cells[pc].m));
+	    DISPLAY(cells[pc].m) = base;
+	}
+	pc++;
+	NEXT();
+    OP(RDB):
+	DISPLAY(cells[pc].m) = FETCH(BP_VALUE());
+	pc++;
+	NEXT();
+
+    // fused instructions, each doing the work of its sequence
+    // (see fusion.h) and continuing after the sequence's last instruction
+    OP(LDL):
+	COUNT(LDL);
+	{
+	    address loc = LITERAL(BP_VALUE()) + cells[pc].m;
+	    word val = FETCH(loc);
+	    PUSH(val);
+	}
+	pc += 2;
+	NEXT();
+    OP(LDO):
+	COUNT(LDO);
+	{
+	    int addr = LITERAL(BP_VALUE());
+	    for (int k = 0; k < cells[pc].n; k++) {
+		addr = FETCH(addr);
+	    }
+	    address loc = (word) addr + cells[pc].m;
+	    word val = FETCH(loc);
+	    PUSH(val);
+	}
+	pc += cells[pc].n + 2;
+	NEXT();
+    OP(STK):
+	COUNT(STK);
+	{
+#ifdef UNCHECKED
+	    word val = cells[pc].n;
+	    address dest = bp + cells[pc].m;
+#else
+	    // both pushes must be possible, as in the original code
+	    PUSH(BP_VALUE());
+	    PUSH(cells[pc].n);
+	    word val = POP();
+	    address dest = POP() + cells[pc].m;
+#endif
+	    ASSIGN(dest, val);
+	}
+	pc += 3;
+	NEXT();
+    OP(ADI):
+	COUNT(ADI);
+	{
+	    word topval = LITERAL(cells[pc].m);
+	    word second = POP();
+	    PUSH(second + topval);
+	}
+	pc += 2;
+	NEXT();
+    OP(SBI):
+	COUNT(SBI);
+	{
+	    int topval = (word) LITERAL(cells[pc].m);
+	    int second = POP();
+	    PUSH(second - topval);
+	}
+	pc += 2;
+	NEXT();
+    OP(JPZ):
+	COUNT(JPZ);
+	if (POP() != 0) {
+	    pc += 2;
+	} else {
+	    // the JMP is at pc+1
+	    if (cells[pc].m <= 1) {
+		USE_FUEL(pc+1);
+	    }
+	    JUMP_TO(pc + cells[pc].m);
+	}
+	NEXT();
+// a fused comparison, JPC 2, and JMP, where the JMP is taken
+// if second cmp topval is false
+#define BRANCH(name, type, cmp)				\
+    OP(name):							\
+	COUNT(name);						\
+	{							\
+	    type topval = POP();				\
+	    type second = POP();				\
+	    if (second cmp topval) {				\
+		pc += 3;					\
+	    } else {						\
+		/* the JMP is at pc+2 */			\
+		if (cells[pc].m <= 2) {				\
+		    USE_FUEL(pc+2);				\
+		}						\
+		JUMP_TO(pc + cells[pc].m);			\
+	    }							\
+	}							\
+	NEXT();
+    BRANCH(BNE, word, ==)
+    BRANCH(BEQ, word, !=)
+    BRANCH(BGE, int, <)
+    BRANCH(BGT, int, <=)
+    BRANCH(BLE, int, >)
+    BRANCH(BLT, int, >=)
+#undef BRANCH
+    OP(LDD):
+	COUNT(LDD);
+	{
+	    address loc = LITERAL(DISPLAY(cells[pc].n)) + cells[pc].m;
+	    word val = FETCH(loc);
+	    PUSH(val);
+	}
+	pc += 2;
+	NEXT();
+#ifdef COMPUTED_GOTO
+ L_END:
+#else
+    default:
+#endif
+	bail_with_error("PC (%d) is outside the code!", pc);
+#ifndef COMPUTED_GOTO
+    }
+#endif
+    // the rest is reached only by goto
+ out_of_fuel:
+    vm->fuel = fuel;
+    *PC = fuel_pc;
+    machine_out_of_fuel(vm, fuel_pc);
+#ifdef UNCHECKED
+ fallback:
+    // let the checked engine continue from here
+    stack_set_registers(&vm->stack, sp, bp);
+    vm->fuel = fuel;
+    *PC = pc;
+#endif
+#ifdef STEPPED
+ out_of_budget:
+    // the next run continues from here
+    vm->fuel = fuel;
+    *PC = pc;
+#endif
+    return false;
+}
+
+#undef PUSH
+#undef POP
+#undef FETCH
+#undef ASSIGN
+#undef ALLOCATE
+#undef SP_VALUE
+#undef BP_VALUE
+#undef JUMP_TO
+#undef DISPLAY
+#undef LITERAL
+#undef COUNT
+#undef STEP
+#undef USE_FUEL
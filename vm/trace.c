@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "instruction.h"
+#include "utilities.h"
+#include "stack.h"
+#include "machine.h"
+#include "vm_api.h"
+#include "trace.h"
+
+// Set up t, not recording
+void trace_create(trace_data *t)
+{
+    t->header = NULL;
+    t->records = NULL;
+    t->capacity = 0;
+    t->filename = NULL;
+    t->map_size = 0;
+    t->dump_steps = 0;
+}
+
+// Stop recording, giving back t's ring
+void trace_destroy(trace_data *t)
+{
+    if (t->header == NULL) {
+	return;
+    }
+    if (t->filename != NULL) {
+	munmap(t->header, t->map_size);
+    } else {
+	free(t->header);
+    }
+    t->header = NULL;
+    t->records = NULL;
+    t->capacity = 0;
+}
+
+// Record into the file named filename
+void trace_set_file(trace_data *t, const char *filename)
+{
+    t->filename = filename;
+}
+
+// Print the last steps records if an error stops the run
+void trace_set_dump_steps(trace_data *t, unsigned int steps)
+{
+    t->dump_steps = steps;
+}
+
+// Is t set to record?
+bool trace_enabled(trace_data *t)
+{
+    return t->filename != NULL || t->dump_steps > 0;
+}
+
+// Start recording a new run, creating t's ring
+void trace_start(trace_data *t)
+{
+    trace_destroy(t);
+    unsigned int capacity = (t->filename != NULL)
+	? TRACE_FILE_STEPS : t->dump_steps;
+    size_t size = sizeof(trace_header) + sizeof(trace_record) * capacity;
+    void *mem;
+    if (t->filename != NULL) {
+	// the file is as big as the whole ring from the start,
+	// so no step is lost if the process crashes
+	int fd = open(t->filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+	    bail_with_error("Cannot open file '%s'", t->filename);
+	}
+	if (ftruncate(fd, size) != 0) {
+	    bail_with_error("Cannot make the trace file '%s'", t->filename);
+	}
+	mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mem == MAP_FAILED) {
+	    bail_with_error("Cannot map the trace file '%s'", t->filename);
+	}
+	t->map_size = size;
+    } else {
+	mem = malloc(size);
+	if (mem == NULL) {
+	    bail_with_error("Not enough space for the trace!");
+	}
+    }
+    t->header = (trace_header *) mem;
+    memcpy(t->header->magic, TRACE_MAGIC, sizeof(t->header->magic));
+    t->header->capacity = capacity;
+    t->header->unused = 0;
+    t->header->count = 0;
+    t->records = (trace_record *) (t->header + 1);
+    t->capacity = capacity;
+}
+
+// Print the step r on out, with only what was recorded:
+// as in the text trace, but with only the top of the stack
+static void print_record(FILE *out, trace_record *r)
+{
+    if (!legal_op_code(r->op)) {
+	bail_with_error("Illegal opcode in the trace: %d", r->op);
+    }
+    instruction instr = { r->op, r->m };
+    fprintf(out, "==> addr: ");
+    print_instr_with_addr(out, r->pc, instr);
+    fprintf(out, "PC: %d BP: %d SP: %d\n", r->next_pc, r->bp, r->sp);
+    fprintf(out, "stack: ");
+    if (r->sp > r->bp) {
+	if (r->sp - 1 > r->bp) {
+	    fprintf(out, "... ");
+	}
+	fprintf(out, "S[%d]: %d ", r->sp - 1, r->tos);
+    }
+    fprintf(out, "\n");
+}
+
+// Print the records of the last n steps (of count) in the ring
+// records (of capacity records) on out
+static void print_last(FILE *out, trace_record records[],
+		       unsigned int capacity, unsigned long count,
+		       unsigned long n)
+{
+    for (unsigned long i = count - n; i < count; i++) {
+	print_record(out, &records[i % capacity]);
+    }
+}
+
+// Print the last dump_steps steps recorded in t
+void trace_dump(trace_data *t, FILE *out)
+{
+    if (t->header == NULL || t->dump_steps == 0) {
+	return;
+    }
+    unsigned long count = t->header->count;
+    unsigned long n = count;
+    if (n > t->capacity) {
+	n = t->capacity;
+    }
+    if (n > t->dump_steps) {
+	n = t->dump_steps;
+    }
+    fprintf(out, "The last %lu steps traced:\n", n);
+    print_last(out, t->records, t->capacity, count, n);
+}
+
+// the input of the traced run (the characters its CHI instructions read),
+// with the next one to be read again
+typedef struct {
+    char *chars;
+    size_t len;
+    size_t next;
+} recorded_input;
+
+// The VM's read hook while the run is done again (see char_io.h)
+static ssize_t read_recorded(void *arg, char *buf, size_t size)
+{
+    recorded_input *in = (recorded_input *) arg;
+    size_t n = in->len - in->next;
+    if (n > size) {
+	n = size;
+    }
+    memcpy(buf, in->chars + in->next, n);
+    in->next += n;
+    return n;
+}
+
+// The VM's write hook while the run is done again: the output
+// was already written by the traced run, so it is dropped
+static ssize_t discard_output(void *arg, const char *buf, size_t size)
+{
+    return size;
+}
+
+// Requires: records has count steps, the whole of a traced run
+// Run the program in the file named code_filename again,
+// printing the trace on stdout as the vm program does,
+// and checking that each step is the one recorded
+static void replay(trace_record records[], unsigned long count,
+		   const char *code_filename)
+{
+    // what the traced run read: the values CHI pushed, up to
+    // the end of its input
+    recorded_input in = { NULL, 0, 0 };
+    in.chars = (char *) malloc(count + 1);
+    if (in.chars == NULL) {
+	bail_with_error("Not enough space to decode the trace!");
+    }
+    for (unsigned long i = 0; i < count; i++) {
+	if (records[i].op == CHI) {
+	    if (records[i].tos == EOF) {
+		break;
+	    }
+	    in.chars[in.len++] = (char) records[i].tos;
+	}
+    }
+
+    vm_t *vm = vm_create();
+    if (vm == NULL) {
+	bail_with_error("Not enough space for the VM!");
+    }
+    vm_set_io(vm, read_recorded, discard_output, &in);
+    vm->tracing = true;
+    machine_load_file(vm, code_filename);
+    print_program(vm, stdout);
+    printf("Tracing ...\n");
+    print_state(vm, stdout);
+    for (unsigned long i = 0; i < count; i++) {
+	trace_record *r = &records[i];
+	if (vm->halt || !vm->tracing || vm->PC != r->pc
+	    || vm->PC < 0 || vm->PC >= vm->code_size) {
+	    bail_with_error("The trace does not match the program '%s'"
+			    " at step %lu", code_filename, i + 1);
+	}
+	trace_execute(vm, stdout, vm->code[vm->PC]);
+	if (vm->PC != r->next_pc || stack_size(&vm->stack) != r->sp
+	    || stack_AR_base(&vm->stack) != r->bp) {
+	    bail_with_error("The trace does not match the program '%s'"
+			    " at step %lu", code_filename, i + 1);
+	}
+    }
+    if (!vm->halt && vm->tracing && 0 <= vm->PC && vm->PC < vm->code_size) {
+	// the run stopped (on an error) before finishing this instruction
+	printf("==> addr: ");
+	print_instr_with_addr(stdout, vm->PC, vm->code[vm->PC]);
+    }
+    vm_destroy(vm);
+    free(in.chars);
+}
+
+// Print the steps in the trace file named trace_filename on stdout
+int trace_decode(const char *trace_filename, const char *code_filename)
+{
+    int fd = open(trace_filename, O_RDONLY);
+    if (fd < 0) {
+	bail_with_error("Cannot open file '%s'", trace_filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+	bail_with_error("Cannot read file '%s'", trace_filename);
+    }
+    size_t size = st.st_size;
+    if (size < sizeof(trace_header)) {
+	bail_with_error("The file '%s' is not a trace", trace_filename);
+    }
+    void *mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+	bail_with_error("Cannot map the trace file '%s'", trace_filename);
+    }
+    trace_header *header = (trace_header *) mem;
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0
+	|| header->capacity == 0
+	|| (size - sizeof(trace_header)) / sizeof(trace_record)
+	   < header->capacity) {
+	bail_with_error("The file '%s' is not a trace", trace_filename);
+    }
+    trace_record *records = (trace_record *) (header + 1);
+    unsigned long count = header->count;
+    if (code_filename != NULL && count <= header->capacity) {
+	replay(records, count, code_filename);
+    } else {
+	unsigned long n = count;
+	if (n > header->capacity) {
+	    n = header->capacity;
+	    printf("(the first %lu steps were overwritten)\n", count - n);
+	}
+	print_last(stdout, records, header->capacity, count, n);
+    }
+    munmap(mem, size);
+    return EXIT_SUCCESS;
+}
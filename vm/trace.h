@@ -0,0 +1,114 @@
+#ifndef _TRACE_H
+#define _TRACE_H
+#include <stdio.h>
+#include <stdbool.h>
+#include "machine_types.h"
+#include "instruction.h"
+#include "stack.h"
+
+// The binary trace (vm -t file or vm -r steps) records each step
+// the machine takes while tracing, instead of printing the instruction
+// and the stack as the text trace does, which is far slower.
+// A step is recorded as a fixed-size record in a ring buffer,
+// which keeps the last steps (the older ones are overwritten).
+// The ring is in memory, or in a file mapped into memory
+// (which keeps the trace even if the process crashes);
+// vm --decode turns such a file back into text (see trace_decode).
+
+// the number of steps kept in a trace file by default
+#define TRACE_FILE_STEPS (1 << 20)
+
+// the first bytes of a trace file
+#define TRACE_MAGIC "PL0TRACE"
+
+// one step of the machine
+typedef struct {
+    int pc;        // the address of the instruction executed
+    int m;         // its M
+    int next_pc;   // PC after it was executed
+    address sp;    // SP after it was executed
+    address bp;    // BP after it was executed
+    word tos;      // the top of the stack after it (0 if SP is 0)
+    unsigned char op; // its opcode
+    unsigned char unused;
+} trace_record;
+
+// the start of a trace (and of a trace file), followed by its records
+typedef struct {
+    char magic[8];          // TRACE_MAGIC (without the null character)
+    unsigned int capacity;  // the number of records in the ring
+    unsigned int unused;
+    unsigned long count;    // the number of steps recorded so far
+} trace_header;
+
+// the binary trace of one VM's run
+typedef struct {
+    // the header and the ring of records (NULL if not recording)
+    trace_header *header;
+    trace_record *records;
+    // the number of steps the ring keeps (0 if not recording)
+    unsigned int capacity;
+    // the file the ring is mapped from (or NULL, if it is in memory),
+    // and the size of the mapping
+    const char *filename;
+    size_t map_size;
+    // the number of the last steps printed if an error stops the run
+    unsigned int dump_steps;
+} trace_data;
+
+// Requires: t is recording, and s is vm's stack after the step
+// Record the step of the instruction instr at address addr,
+// after which PC is new_pc
+#define TRACE_STEP(t, addr, instr, new_pc, s)				\
+    do {								\
+	trace_record *r_ =						\
+	    &(t)->records[(t)->header->count % (t)->capacity];		\
+	r_->pc = (addr);						\
+	r_->m = (instr).m;						\
+	r_->next_pc = (new_pc);						\
+	r_->sp = stack_size(s);						\
+	r_->bp = stack_AR_base(s);					\
+	r_->tos = (r_->sp > 0) ? stack_top(s) : 0;			\
+	r_->op = (instr).op;						\
+	(t)->header->count++;						\
+    } while (0)
+
+// Set up t, not recording
+extern void trace_create(trace_data *t);
+
+// Stop recording, giving back (or unmapping) t's ring
+extern void trace_destroy(trace_data *t);
+
+// Record into the file named filename (in TRACE_FILE_STEPS records)
+extern void trace_set_file(trace_data *t, const char *filename);
+
+// Requires: steps > 0
+// Print the last steps records if an error stops the run;
+// if no file was given, the ring is in memory and keeps that many steps
+extern void trace_set_dump_steps(trace_data *t, unsigned int steps);
+
+// Is t recording a run?
+#define TRACE_RECORDING(t) ((t)->header != NULL)
+
+// Is t set to record (with trace_set_file or trace_set_dump_steps)?
+extern bool trace_enabled(trace_data *t);
+
+// Requires: trace_enabled(t)
+// Start recording a new run (with no steps), creating t's ring
+extern void trace_start(trace_data *t);
+
+// Requires: out is open for writing
+// Print the last dump_steps steps recorded in t, if it is recording
+extern void trace_dump(trace_data *t, FILE *out);
+
+// Print the steps in the trace file named trace_filename on stdout.
+// If code_filename is not NULL, it names the traced program; if the
+// trace also has all the steps of the run (none were overwritten),
+// the program is run again, taking its input from the trace,
+// to print the trace exactly as the vm program prints it
+// (without -n); otherwise each step is printed with only what was
+// recorded: the instruction, the registers, and the top of the stack.
+// Return EXIT_SUCCESS (or bail with an error).
+extern int trace_decode(const char *trace_filename,
+			const char *code_filename);
+#endif
@@ -1,25 +1,77 @@
-/* $Id: utilities.c,v 1.7 2023/01/25 14:11:04 leavens Exp $ */
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <errno.h>
-#include "utilities.h"
-
-// Format a string error message and print it followed by a newline on stderr
-// using perror (for an OS error, if the errno is not 0)
-// then exit with a failure code, so a call to this does not return.
-void bail_with_error(const char *fmt, ...)
-{
-    extern int errno;
-    fflush(stdout); // flush so output comes after what has happened already
-    va_list(args);
-    va_start(args, fmt);
-    char buff[2048];
-    vsprintf(buff, fmt, args);
-    if (errno != 0) {
-	perror(buff);
-    } else {
-	fprintf(stderr, "%s\n", buff);
-    }
-    exit(EXIT_FAILURE);
-}
+/* $Id: utilities.c,v 1.7 2023/01/25 14:11:04 leavens Exp $ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "char_io.h"
+#include "utilities.h"
+
+// the error trap for the VM running in this thread (or NULL)
+_Thread_local error_trap *error_trap_current = NULL;
+
+// the character I/O of the VM running in this thread (or NULL)
+_Thread_local char_io *error_io_current = NULL;
+
+// Requires: error_trap_current != NULL
+// Put the message in buff (with the OS error, if errno is not 0)
+// in the current error trap and jump to it
+static void trap_error(const char *buff)
+{
+    if (errno != 0) {
+	snprintf(error_trap_current->message, ERROR_MESSAGE_SIZE, "%s: %s",
+		 buff, strerror(errno));
+    } else {
+	snprintf(error_trap_current->message, ERROR_MESSAGE_SIZE, "%s",
+		 buff);
+    }
+    longjmp(error_trap_current->env, 1);
+}
+
+// Format a string error message and print it followed by a newline on stderr
+// using perror (for an OS error, if the errno is not 0)
+// after flushing the VM's output (see char_io.h)
+// then exit with a failure code, so a call to this does not return.
+void bail_with_error(const char *fmt, ...)
+{
+    extern int errno;
+    int saved_errno = errno;
+    va_list(args);
+    va_start(args, fmt);
+    char buff[ERROR_MESSAGE_SIZE];
+    vsnprintf(buff, sizeof(buff), fmt, args);
+    va_end(args);
+    if (error_trap_current != NULL) {
+	errno = saved_errno;
+	trap_error(buff);
+    }
+    // flush so output comes after what has happened already
+    fflush(stdout);
+    if (error_io_current != NULL) {
+	char_io_flush(error_io_current);
+    }
+    errno = saved_errno;
+    if (errno != 0) {
+	perror(buff);
+    } else {
+	fprintf(stderr, "%s\n", buff);
+    }
+    exit(EXIT_FAILURE);
+}
+
+// Format a string error message and print it followed by a newline
+// on stderr, then exit with a failure code
+void exit_with_error(const char *fmt, ...)
+{
+    va_list(args);
+    va_start(args, fmt);
+    char buff[ERROR_MESSAGE_SIZE];
+    vsnprintf(buff, sizeof(buff), fmt, args);
+    va_end(args);
+    if (error_trap_current != NULL) {
+	errno = 0;
+	trap_error(buff);
+    }
+    fprintf(stderr, "%s\n", buff);
+    exit(EXIT_FAILURE);
+}
@@ -1,8 +1,34 @@
-/* $Id: utilities.h,v 1.5 2023/01/25 14:11:04 leavens Exp $ */
-#ifndef _UTILITIES_H
-#define _UTILITIES_H
-
-// Format a string error message and print it using perror (for an OS error)
-// then exit with a failure code, so a call to this does not return.
-extern void bail_with_error(const char *fmt, ...);
-#endif
+/* $Id: utilities.h,v 1.5 2023/01/25 14:11:04 leavens Exp $ */
+#ifndef _UTILITIES_H
+#define _UTILITIES_H
+#include <setjmp.h>
+#include "char_io.h"
+
+// the longest error message kept by an error_trap
+#define ERROR_MESSAGE_SIZE 2048
+
+// Where the errors of a VM run inside a program (see vm_api.h)
+// go instead of ending the process
+typedef struct {
+    jmp_buf env; // where to jump to (with longjmp) on an error
+    char message[ERROR_MESSAGE_SIZE]; // the error's message
+} error_trap;
+
+// the error trap for the VM running in this thread
+// (NULL, as in the vm program, if errors exit)
+extern _Thread_local error_trap *error_trap_current;
+
+// the character I/O (see char_io.h) of the VM running in this thread,
+// whose output is flushed before an error message is printed (or NULL)
+extern _Thread_local char_io *error_io_current;
+
+// Format a string error message and print it using perror (for an OS error)
+// then exit with a failure code, so a call to this does not return;
+// if error_trap_current is not NULL, put the message in it
+// and jump to it instead.
+extern void bail_with_error(const char *fmt, ...);
+
+// Like bail_with_error, but without flushing the VM's output first
+// (it is flushed when the process exits) and without an OS error.
+extern void exit_with_error(const char *fmt, ...);
+#endif
@@ -0,0 +1,250 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include "machine_types.h"
+#include "instruction.h"
+#include "utilities.h"
+#include "machine.h"
+#include "verifier.h"
+
+// a place to continue the verification of a procedure
+typedef struct {
+    int pc;     // address of the next instruction
+    int height; // stack height (SP - BP) before it executes
+} pending;
+
+// The verifier's state is kept for each thread,
+// as each thread can verify a program for its own VM.
+
+// the entry address of the procedure that each instruction belongs to
+// (size elements)
+static _Thread_local int *owner;
+
+// the entry addresses of the procedures, in the order found
+// (at most size of them)
+static _Thread_local int *entries;
+static _Thread_local int num_entries;
+
+// the frame size of the procedure starting at each address,
+// or -1 if no procedure starts there (size elements)
+static _Thread_local int *frame_sizes;
+
+// the stack height each procedure starts with: the size of the links
+// pushed by the calls of it (size elements, set where frame_sizes is)
+static _Thread_local int *start_heights;
+
+// the successors still to be verified in the current procedure
+// (each instruction adds at most 2 successors, once, so 2*size+1 elements)
+static _Thread_local pending *work;
+static _Thread_local int num_work;
+
+// Return a new array of n elements of the given size, bailing if
+// there is not enough space
+static void *allocate(size_t n, size_t size)
+{
+    void *ret = malloc(n * size);
+    if (ret == NULL) {
+	bail_with_error("Not enough space to verify the program!");
+    }
+    return ret;
+}
+
+// Record that entry (the target of a call that pushes links of the
+// given size) starts a procedure, unless it was already recorded;
+// return false if it was, by calls that push links of another size
+static bool add_entry(int entry, int links)
+{
+    if (frame_sizes[entry] < 0) {
+	frame_sizes[entry] = 0;
+	start_heights[entry] = links;
+	entries[num_entries++] = entry;
+    }
+    return start_heights[entry] == links;
+}
+
+// Requires: 0 <= pc < size
+// Verify the basic block starting at pc (with the given height)
+// in the procedure starting at entry,
+// adding its successors to the work list;
+// return the maximum height reached in the block, or -1 if it fails.
+static int verify_block(instruction code[], int size, verified_instr info[],
+			int entry, int pc, int height)
+{
+    int max = height;
+    for (;;) {
+	if (info[pc].height >= 0) {
+	    // already verified, so the block joins another one here
+	    if (info[pc].height != height || owner[pc] != entry) {
+		return -1;
+	    }
+	    return max;
+	}
+	info[pc].height = height;
+	owner[pc] = entry;
+
+	// the number of words popped and pushed by this instruction
+	int pops = 0;
+	int pushes = 0;
+	// the next address, if execution can continue to it
+	int next = pc+1;
+	instruction instr = code[pc];
+	switch (instr.op) {
+	case NOP: case NDB:
+	    break;
+	case LIT: case CHI: case PSP: case PBP: case PPC:
+	    pushes = 1;
+	    break;
+	case POP: case CHO:
+	    pops = 1;
+	    break;
+	case PSI: case LOD: case NEG:
+	    pops = 1;
+	    pushes = 1;
+	    break;
+	case STO:
+	    pops = 2;
+	    break;
+	case ADD: case SUB: case MUL: case DIV: case MOD:
+	case EQL: case NEQ: case LSS: case LEQ: case GTR: case GEQ:
+	    pops = 2;
+	    pushes = 1;
+	    break;
+	case INC:
+	    if (instr.m < 0) {
+		pops = - instr.m;
+	    } else {
+		pushes = instr.m;
+	    }
+	    break;
+	case JMP:
+	    next = pc + instr.m;
+	    break;
+	case JPC:
+	    pops = 1;
+	    if (pc + instr.m < 0 || size <= pc + instr.m) {
+		return -1;
+	    }
+	    work[num_work].pc = pc + instr.m;
+	    work[num_work].height = height - 1;
+	    num_work++;
+	    break;
+	case CAL: case CNL:
+	    // the callee's frame is checked separately;
+	    // after it returns, the height is unchanged
+	    if (instr.m < 0 || size <= instr.m
+		|| !add_entry(instr.m, (instr.op == CAL) ? LINKS_SIZE
+			      : LINKS_SIZE_NO_STAT_LNK)) {
+		return -1;
+	    }
+	    break;
+	case RTN: case RNL:
+	    // the links must be on the stack;
+	    // where it returns to is checked when it executes
+	    if (height < ((instr.op == RTN) ? LINKS_SIZE
+			  : LINKS_SIZE_NO_STAT_LNK)) {
+		return -1;
+	    }
+	    return max;
+	case PDB:
+	    if (instr.m < 0 || DISPLAY_SIZE <= instr.m) {
+		return -1;
+	    }
+	    pushes = 1;
+	    break;
+	case SDB: case RDB:
+	    // these use the word at BP, so it must be in the frame
+	    if (instr.m < 0 || DISPLAY_SIZE <= instr.m || height < 1) {
+		return -1;
+	    }
+	    break;
+	case HLT:
+	    return max;
+	default: // JMI and anything else cannot be verified
+	    return -1;
+	}
+	if (height < pops) {
+	    return -1;
+	}
+	height = height - pops + pushes;
+	if (height > max) {
+	    max = height;
+	}
+	if (next < 0 || size <= next) {
+	    return -1;
+	}
+	pc = next;
+    }
+}
+
+// Requires: owner, entries, frame_sizes, and work have been allocated
+//           for size instructions, and info[i].height is -1 for each i
+// Verify each procedure of the program, starting with the main program
+// at address 0, filling in info, and return true if they all verify.
+static bool verify_procedures(instruction code[], int size,
+			      verified_instr info[])
+{
+    for (int i = 0; i < size; i++) {
+	frame_sizes[i] = -1;
+    }
+    num_entries = 0;
+    add_entry(0, 0);
+    // the main program starts with an empty stack,
+    // procedures start with the links just pushed by CAL (or CNL)
+    for (int e = 0; e < num_entries; e++) {
+	int entry = entries[e];
+	int start_height = start_heights[entry];
+	if (info[entry].height >= 0) {
+	    // the entry was already reached from some other code
+	    return false;
+	}
+	int frame_size = start_height;
+	num_work = 0;
+	work[num_work].pc = entry;
+	work[num_work].height = start_height;
+	num_work++;
+	while (num_work > 0) {
+	    num_work--;
+	    pending p = work[num_work];
+	    int max = verify_block(code, size, info, entry, p.pc, p.height);
+	    if (max < 0) {
+		return false;
+	    }
+	    if (max > frame_size) {
+		frame_size = max;
+	    }
+	}
+	frame_sizes[entry] = frame_size;
+    }
+    for (int i = 0; i < size; i++) {
+	if (info[i].height >= 0) {
+	    info[i].frame_size = frame_sizes[owner[i]];
+	}
+    }
+    return true;
+}
+
+// Requires: code has at least size elements and info has at least
+//           size elements
+// Verify the program in code (which has size instructions),
+// filling in info for each address, and return true if it verifies.
+bool verify_program(instruction code[], int size, verified_instr info[])
+{
+    for (int i = 0; i < size; i++) {
+	info[i].height = -1;
+	info[i].frame_size = 0;
+    }
+    if (size <= 0) {
+	return false;
+    }
+    owner = allocate(size, sizeof(int));
+    entries = allocate(size, sizeof(int));
+    frame_sizes = allocate(size, sizeof(int));
+    start_heights = allocate(size, sizeof(int));
+    work = allocate(2*size+1, sizeof(pending));
+    bool verified = verify_procedures(code, size, info);
+    free(owner);
+    free(entries);
+    free(frame_sizes);
+    free(start_heights);
+    free(work);
+    return verified;
+}
@@ -0,0 +1,36 @@
+#ifndef _VERIFIER_H
+#define _VERIFIER_H
+#include <stdbool.h>
+#include "instruction.h"
+
+// What the verifier learned about the instruction at one address
+typedef struct {
+    // the height of the stack (SP - BP) just before this instruction
+    // executes, or -1 if the instruction cannot be reached
+    int height;
+    // the greatest height the stack reaches in the frame
+    // of the procedure (or main program) this instruction belongs to
+    int frame_size;
+} verified_instr;
+
+// Requires: code has at least size elements and info has at least
+//           size elements
+// Verify the program in code (which has size instructions),
+// filling in info for each address, and return true if it verifies.
+// A program verifies if, starting from address 0 with an empty stack,
+// every reachable instruction is always executed with the same
+// stack height relative to BP, no instruction pops below BP,
+// every jump and call target is inside the program,
+// and no JMI instruction (whose target is not known) can be reached.
+// The heights are computed for each basic block (extended to the
+// next control transfer), and the maximum height for each procedure
+// (the code reachable from a CAL or CNL target, with the links already
+// pushed, all its calls pushing links of the same size)
+// is its frame size.
+// For a verified program, an interpreter that checks at each CAL
+// that BP + frame_size fits on the stack, and at each RTN that
+// the new height matches the height recorded for the return address,
+// can skip all other checks on pushes and pops.
+extern bool verify_program(instruction code[], int size,
+			   verified_instr info[]);
+#endif
@@ -0,0 +1,417 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "machine_types.h"
+#include "instruction.h"
+#include "utilities.h"
+#include "stack.h"
+
+// The ahead-of-time translator (vm2c): it reads a program in the VM's
+// text format and writes a standalone C program that does what the VM
+// does when it runs that program without tracing (vm -n), with the same
+// output and error messages. Each instruction becomes a labeled
+// statement, JMP and JPC become gotos to the labels of their targets,
+// CAL (or CNL) pushes the links and jumps to the callee, and RTN
+// (or RNL, like JMI)
+// jumps through a switch on the return address; the stack is a local
+// array, and each push and pop is checked as the stack module does.
+// Compiled with gcc -O2, the result runs the program at native speed.
+
+/* Print a usage message on stderr
+   and exit with failure. */
+static void usage(const char *cmdname)
+{
+    fprintf(stderr, "Usage: %s [-s height] [-o file.c] code-filename\n",
+	    cmdname);
+    exit(EXIT_FAILURE);
+}
+
+// Read the program from prog, setting *size to the number
+// of instructions, and return them (in a new array)
+static instruction *read_program(FILE *prog, int *size)
+{
+    instruction *code = NULL;
+    int capacity = 0;
+    bool stop_reading = false;
+    int count = 0;
+    for (;;) {
+	if (count == capacity) {
+	    capacity = (capacity == 0) ? 512 : 2 * capacity;
+	    code = (instruction *) realloc(code, sizeof(instruction) * capacity);
+	    if (code == NULL) {
+		bail_with_error("Not enough space for %d instructions!",
+				capacity);
+	    }
+	}
+	code[count] = read_instruction(prog, &stop_reading);
+	if (stop_reading) {
+	    break;
+	}
+	count++;
+    }
+    *size = count;
+    return code;
+}
+
+// the start of each generated program, up to the stack's maximum height
+static const char *prelude =
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <stdarg.h>\n"
+    "\n"
+    "typedef short int word;\n"
+    "typedef unsigned short int address;\n"
+    "\n"
+    "// Print the error message on stderr after the output so far, and exit\n"
+    "static inline void bail(const char *fmt, ...)\n"
+    "{\n"
+    "    va_list args;\n"
+    "    fflush(stdout);\n"
+    "    va_start(args, fmt);\n"
+    "    vfprintf(stderr, fmt, args);\n"
+    "    va_end(args);\n"
+    "    fputc('\\n', stderr);\n"
+    "    exit(EXIT_FAILURE);\n"
+    "}\n"
+    "\n"
+    "// Report that BP is above SP (the output is written when this exits)\n"
+    "static inline void invariant_failure(address sp, address bp)\n"
+    "{\n"
+    "    fprintf(stderr, \"VM stack invariant failure: SP (%%d) < BP (%%d)!\\n\",\n"
+    "            sp, bp);\n"
+    "    exit(EXIT_FAILURE);\n"
+    "}\n"
+    "\n"
+    "// the stack operations, checked as in the VM's stack module\n"
+    "#define PUSH(v)\t\t\t\t\t\t\t\\\n"
+    "    do {\t\t\t\t\t\t\t\t\\\n"
+    "\tword v_ = (v);\t\t\t\t\t\t\t\\\n"
+    "\tif (sp == MAX_HEIGHT-1) {\t\t\t\t\t\\\n"
+    "\t    bail(\"Trying to push on a full stack!\\n\");\t\t\\\n"
+    "\t}\t\t\t\t\t\t\t\t\\\n"
+    "\tstk[sp++] = v_;\t\t\t\t\t\t\t\\\n"
+    "    } while (0)\n"
+    "#define POP(x)\t\t\t\t\t\t\t\t\\\n"
+    "    do {\t\t\t\t\t\t\t\t\\\n"
+    "\tif (sp == 0) {\t\t\t\t\t\t\t\\\n"
+    "\t    bail(\"Trying to pop an empty stack!\");\t\t\t\\\n"
+    "\t}\t\t\t\t\t\t\t\t\\\n"
+    "\t(x) = stk[--sp];\t\t\t\t\t\t\\\n"
+    "    } while (0)\n"
+    "#define FETCH(a)\t\t\t\t\t\t\t\\\n"
+    "    (((address) (a) < MAX_HEIGHT) ? stk[(address) (a)]\t\t\\\n"
+    "     : (bail(\"Illegal stack index in stack_fetch: %%d\", (address) (a)), 0))\n"
+    "#define ASSIGN(a, v)\t\t\t\t\t\t\t\\\n"
+    "    do {\t\t\t\t\t\t\t\t\\\n"
+    "\tif ((address) (a) >= MAX_HEIGHT) {\t\t\t\t\\\n"
+    "\t    bail(\"Illegal stack index in stack_assign: %%d\", (address) (a)); \\\n"
+    "\t}\t\t\t\t\t\t\t\t\\\n"
+    "\tstk[(address) (a)] = (v);\t\t\t\t\t\\\n"
+    "    } while (0)\n"
+    "\n"
+    "// the maximum height of the stack\n"
+    "#define MAX_HEIGHT %d\n"
+    "\n"
+    "int main()\n"
+    "{\n"
+    "    // the stack, which starts out all zeros, and its registers\n"
+    "    word stk[MAX_HEIGHT] = { 0 };\n"
+    "    address sp = 0;\n"
+    "    address bp = 0;\n"
+    "    // the display (see PDB, SDB, and RDB), which starts out all zeros\n"
+    "    address display[%d] = { 0 };\n"
+    "    // a value popped\n"
+    "    word t;\n"
+    "    // (not every program uses them)\n"
+    "    (void) stk; (void) sp; (void) bp; (void) display; (void) t;\n";
+
+// Emit on out the statement that makes the machine continue at
+// address target (in a program with size instructions)
+static void emit_goto(FILE *out, int target, int size)
+{
+    if (0 <= target && target < size) {
+	fprintf(out, "goto L%d;", target);
+    } else {
+	fprintf(out, "bail(\"PC (%%d) is outside the code!\", %d);", target);
+    }
+}
+
+// Emit on out a binary operation that pops its operands (into
+// variables of the given type) and pushes the result of expr,
+// which uses them as top and second
+static void emit_binary(FILE *out, const char *type, const char *expr)
+{
+    fprintf(out, "{ %s top, second; POP(top); POP(second); PUSH(%s); }",
+	    type, expr);
+}
+
+// Emit on out the C code for instr, at address pc in a program
+// with size instructions
+// (labeled if it is the target of a jump)
+static void emit_instruction(FILE *out, int pc, instruction instr, int size,
+			     bool target)
+{
+    if (target) {
+	fprintf(out, " L%d:", pc);
+    }
+    fprintf(out, " // %d: %s %d\n    ", pc, mnemonic(instr.op), instr.m);
+    switch (instr.op) {
+    case NOP: case NDB:
+	fprintf(out, ";");
+	break;
+    case LIT:
+	fprintf(out, "PUSH(%d);", instr.m);
+	break;
+    case RTN:
+	fprintf(out, "POP(t); pc = t; POP(t); bp = t; POP(t);\n");
+	fprintf(out, "    if (bp > sp) { invariant_failure(sp, bp); }\n");
+	fprintf(out, "    goto dispatch;");
+	break;
+    case RNL:
+	fprintf(out, "POP(t); pc = t; POP(t); bp = t;\n");
+	fprintf(out, "    if (bp > sp) { invariant_failure(sp, bp); }\n");
+	fprintf(out, "    goto dispatch;");
+	break;
+    case CAL:
+	fprintf(out, "{ address old_sp = sp; word link = FETCH(bp);\n");
+	fprintf(out, "      PUSH(link); PUSH(bp); PUSH(%d); bp = old_sp; }\n",
+		pc + 1);
+	fprintf(out, "    ");
+	emit_goto(out, instr.m, size);
+	break;
+    case CNL:
+	fprintf(out, "{ address old_sp = sp; PUSH(bp); PUSH(%d); bp = old_sp; }\n",
+		pc + 1);
+	fprintf(out, "    ");
+	emit_goto(out, instr.m, size);
+	break;
+    case POP:
+	fprintf(out, "POP(t);");
+	break;
+    case PSI:
+	fprintf(out, "{ POP(t); int addr = t; word val = FETCH(addr); "
+		"PUSH(val); }");
+	break;
+    case LOD:
+	fprintf(out, "{ POP(t); address loc = t + %d; word val = FETCH(loc); "
+		"PUSH(val); }", instr.m);
+	break;
+    case STO:
+	fprintf(out, "{ word val; POP(val); POP(t); address dest = t + %d;\n"
+		"      ASSIGN(dest, val); }", instr.m);
+	break;
+    case INC:
+	fprintf(out, "{ int new_sp = sp + (unsigned int) %d;\n", instr.m);
+	fprintf(out, "      if (new_sp < 0 || new_sp >= MAX_HEIGHT) {\n");
+	fprintf(out, "\t  bail(\"Can't increase stack size to %%d"
+		" in stack_allocate\", new_sp);\n");
+	fprintf(out, "      }\n");
+	fprintf(out, "      sp = new_sp;\n");
+	fprintf(out, "      if (bp > sp) { invariant_failure(sp, bp); } }");
+	break;
+    case JMP:
+	emit_goto(out, pc + instr.m, size);
+	break;
+    case JPC:
+	fprintf(out, "POP(t); if (t != 0) { ");
+	emit_goto(out, pc + instr.m, size);
+	fprintf(out, " }");
+	break;
+    case CHO:
+	fprintf(out, "POP(t); putchar(t);");
+	break;
+    case CHI:
+	fprintf(out, "{ int c = getchar(); PUSH(c); }");
+	break;
+    case HLT:
+	fprintf(out, "return EXIT_SUCCESS;");
+	break;
+    case NEG:
+	fprintf(out, "POP(t); PUSH(- t);");
+	break;
+    case ADD:
+	emit_binary(out, "word", "second + top");
+	break;
+    case SUB:
+	emit_binary(out, "int", "second - top");
+	break;
+    case MUL:
+	emit_binary(out, "word", "second * top");
+	break;
+    case DIV:
+	fprintf(out, "{ word top, second; POP(top); POP(second);\n");
+	fprintf(out, "      if (top == 0) { bail(\"Divisor is zero"
+		" in DIV instruction!\"); }\n");
+	fprintf(out, "      PUSH(second / top); }");
+	break;
+    case MOD:
+	fprintf(out, "{ word top, second; POP(top); POP(second);\n");
+	fprintf(out, "      if (top == 0) { bail(\"Modulus is zero"
+		" in MOD instruction!\"); }\n");
+	fprintf(out, "      PUSH(second %% top); }");
+	break;
+    case EQL:
+	emit_binary(out, "word", "second == top");
+	break;
+    case NEQ:
+	emit_binary(out, "word", "second != top");
+	break;
+    case LSS:
+	emit_binary(out, "int", "second < top");
+	break;
+    case LEQ:
+	emit_binary(out, "int", "second <= top");
+	break;
+    case GTR:
+	emit_binary(out, "int", "second > top");
+	break;
+    case GEQ:
+	emit_binary(out, "int", "second >= top");
+	break;
+    case PSP:
+	fprintf(out, "PUSH(sp);");
+	break;
+    case PBP:
+	fprintf(out, "PUSH(bp);");
+	break;
+    case PPC:
+	fprintf(out, "PUSH(%d);", pc + 1);
+	break;
+    case JMI:
+	fprintf(out, "POP(t); pc = t; goto dispatch;");
+	break;
+    case PDB: case SDB: case RDB:
+	if (instr.m < 0 || instr.m >= DISPLAY_SIZE) {
+	    // as the VM reports it when the instruction executes
+	    fprintf(out, "bail(\"Illegal display level (%d), must be less"
+		    " than %d!\");", instr.m, DISPLAY_SIZE);
+	} else if (instr.op == PDB) {
+	    fprintf(out, "PUSH(display[%d]);", instr.m);
+	} else if (instr.op == SDB) {
+	    fprintf(out, "ASSIGN(bp, display[%d]); display[%d] = bp;",
+		    instr.m, instr.m);
+	} else {
+	    fprintf(out, "display[%d] = FETCH(bp);", instr.m);
+	}
+	break;
+    default:
+	bail_with_error("Undefined opcode: %d", instr.op);
+	break;
+    }
+    fprintf(out, "\n");
+}
+
+// Emit on out the C program for the program in code
+// (which has size instructions), with a stack of the given height
+static void emit_program(FILE *out, const char *filename,
+			 instruction code[], int size, int height)
+{
+    fprintf(out, "/* Generated by vm2c from %s; do not edit */\n",
+	    filename);
+    fprintf(out, prelude, height, DISPLAY_SIZE);
+    // RTN, RNL, and JMI jump to computed addresses, through a switch
+    // (so every instruction is a target), and the others to fixed ones
+    bool dispatching = false;
+    bool *targets = (bool *) calloc(size + 1, sizeof(bool));
+    if (targets == NULL) {
+	bail_with_error("Not enough space to translate %d instructions!",
+			size);
+    }
+    targets[0] = true;
+    for (int pc = 0; pc < size; pc++) {
+	int target = -1;
+	switch (code[pc].op) {
+	case RTN: case RNL: case JMI:
+	    dispatching = true;
+	    break;
+	case CAL: case CNL:
+	    target = code[pc].m;
+	    break;
+	case JMP: case JPC:
+	    target = pc + code[pc].m;
+	    break;
+	}
+	if (0 <= target && target < size) {
+	    targets[target] = true;
+	}
+    }
+    if (dispatching) {
+	fprintf(out, "    // the target of RTN, RNL, and JMI\n");
+	fprintf(out, "    int pc;\n");
+    }
+    fprintf(out, "\n    ");
+    emit_goto(out, 0, size);
+    fprintf(out, "\n");
+    for (int pc = 0; pc < size; pc++) {
+	emit_instruction(out, pc, code[pc], size,
+			 dispatching || targets[pc]);
+    }
+    // running off the end of the code
+    fprintf(out, "    ");
+    emit_goto(out, size, size);
+    fprintf(out, "\n");
+    if (dispatching) {
+	// where RTN, RNL, and JMI continue
+	fprintf(out, "\n dispatch:\n");
+	fprintf(out, "    switch (pc) {\n");
+	for (int pc = 0; pc < size; pc++) {
+	    fprintf(out, "    case %d: goto L%d;\n", pc, pc);
+	}
+	fprintf(out, "    default:\n");
+	fprintf(out, "\tbail(\"PC (%%d) is outside the code!\", pc);\n");
+	fprintf(out, "    }\n");
+    }
+    fprintf(out, "    return EXIT_FAILURE;\n");
+    fprintf(out, "}\n");
+    free(targets);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *cmdname = argv[0];
+    int height = STACK_DEFAULT_HEIGHT;
+    const char *out_name = NULL;
+    argc--;
+    argv++;
+    // possible options: -s height and -o file.c
+    while (argc > 1 && argv[0][0] == '-') {
+	if (strcmp(argv[0], "-s") == 0) {
+	    // -s sets the maximum height of the stack, as in the VM
+	    height = atoi(argv[1]);
+	    if (height <= 0 || height > STACK_CAPACITY) {
+		usage(cmdname);
+	    }
+	} else if (strcmp(argv[0], "-o") == 0) {
+	    // -o names the file to write the C program to
+	    out_name = argv[1];
+	} else {
+	    usage(cmdname);
+	}
+	argc -= 2;
+	argv += 2;
+    }
+    if (argc != 1 || argv[0][0] == '-') {
+	usage(cmdname);
+    }
+
+    FILE *prog = fopen(argv[0], "r");
+    if (prog == NULL) {
+	bail_with_error("Cannot open file '%s'", argv[0]);
+    }
+    int size;
+    instruction *code = read_program(prog, &size);
+    fclose(prog);
+    FILE *out = stdout;
+    if (out_name != NULL) {
+	out = fopen(out_name, "w");
+	if (out == NULL) {
+	    bail_with_error("Cannot open file '%s'", out_name);
+	}
+    }
+    emit_program(out, argv[0], code, size, height);
+    if (fclose(out) == EOF) {
+	bail_with_error("Cannot write the C program");
+    }
+    free(code);
+    return EXIT_SUCCESS;
+}
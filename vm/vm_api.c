@@ -0,0 +1,217 @@
+// for fmemopen
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <setjmp.h>
+#include "utilities.h"
+#include "stack.h"
+#include "char_io.h"
+#include "bytecode.h"
+#include "jit.h"
+#include "machine.h"
+#include "vm_api.h"
+
+// Return a new VM, with no program loaded, that does not trace
+vm_t *vm_create()
+{
+    vm_t *vm = (vm_t *) malloc(sizeof(vm_t));
+    if (vm == NULL) {
+	return NULL;
+    }
+    machine_create(vm);
+    vm->tracing = false;
+    vm->trap.message[0] = '\0';
+    return vm;
+}
+
+// Give back all the space used by vm
+void vm_destroy(vm_t *vm)
+{
+    machine_destroy(vm);
+    free(vm);
+}
+
+// Make vm's CHO and CHI instructions use the given hooks
+void vm_set_io(vm_t *vm, char_io_read_fn read, char_io_write_fn write,
+	       void *arg)
+{
+    char_io_set_hooks(&vm->io, read, write, arg);
+}
+
+// Use the given engine to run programs, if there is such an engine
+bool vm_set_engine(vm_t *vm, engine_kind engine)
+{
+    if (engine == engine_jit && !jit_available()) {
+	return false;
+    }
+    vm->engine = engine;
+    return true;
+}
+
+// Set the maximum height of vm's stack, if height is legal
+bool vm_set_stack_height(vm_t *vm, int height)
+{
+    if (height <= 0 || height > STACK_CAPACITY) {
+	return false;
+    }
+    stack_set_max_height(&vm->stack, height);
+    return true;
+}
+
+// Count the instructions vm executes if counting is true
+void vm_set_counting(vm_t *vm, bool counting)
+{
+    vm->counting = counting;
+}
+
+// Limit the programs vm runs to fuel calls and backward jumps
+void vm_set_fuel(vm_t *vm, unsigned long fuel)
+{
+    machine_set_fuel(vm, fuel);
+}
+
+// The calls of vm_load and vm_run are bracketed by TRAP_ERRORS
+// and END_TRAP: an error in between (reported with bail_with_error)
+// puts its message in vm->trap and continues after TRAP_ERRORS
+// with failed set to true, instead of ending the process
+// (failed is volatile, as it is changed after setjmp returns,
+// and setjmp is only called as the condition of an if, as C requires).
+// The trap is set for this thread only, and the one that was set
+// before (if this is called while another VM is running) is restored.
+#define TRAP_ERRORS(vm, failed)						\
+    error_trap *saved_trap = error_trap_current;			\
+    char_io *saved_io = error_io_current;				\
+    error_trap_current = &(vm)->trap;					\
+    error_io_current = &(vm)->io;					\
+    (vm)->trap.message[0] = '\0';					\
+    volatile bool failed = false;					\
+    if (setjmp((vm)->trap.env) != 0) {					\
+	failed = true;							\
+    }
+
+#define END_TRAP()							\
+    do {								\
+	error_trap_current = saved_trap;				\
+	error_io_current = saved_io;					\
+    } while (0)
+
+// Load the program in buf (size bytes) into vm
+bool vm_load(vm_t *vm, const char *buf, size_t size)
+{
+    // the stream a text program is read from, which is closed
+    // even if an error in the program jumps out of reading it
+    // (volatile, as it is changed after setjmp returns)
+    FILE *volatile prog = NULL;
+    TRAP_ERRORS(vm, failed);
+    if (!failed) {
+	instruction *code;
+	int entry;
+	int num = bytecode_load_buffer(buf, size, &code, &entry);
+	if (num >= 0) {
+	    machine_load_code(vm, code, num, true, entry);
+	} else if (size == 0) {
+	    // fmemopen cannot open an empty buffer
+	    machine_load_code(vm, NULL, 0, false, 0);
+	} else {
+	    prog = fmemopen((void *) buf, size, "r");
+	    if (prog == NULL) {
+		bail_with_error("Cannot read the program from its buffer");
+	    }
+	    machine_load_text(vm, prog);
+	}
+    }
+    END_TRAP();
+    if (prog != NULL) {
+	fclose(prog);
+    }
+    vm->failed = failed;
+    return !failed;
+}
+
+// Load the program in the file named filename into vm
+bool vm_load_file(vm_t *vm, const char *filename)
+{
+    // the file a text program is read from, closed as in vm_load
+    FILE *volatile prog = NULL;
+    TRAP_ERRORS(vm, failed);
+    if (!failed && !machine_load_bytecode(vm, filename)) {
+	// not in the bytecode format, so read it as text
+	prog = open_instruction_file(filename);
+	machine_load_text(vm, prog);
+    }
+    END_TRAP();
+    if (prog != NULL) {
+	fclose(prog);
+    }
+    vm->failed = failed;
+    return !failed;
+}
+
+// Make vm ready to run its program again from the start
+void vm_restart(vm_t *vm)
+{
+    TRAP_ERRORS(vm, failed);
+    if (!failed) {
+	machine_restart(vm);
+    }
+    END_TRAP();
+    vm->failed = failed;
+}
+
+// Run vm's program until it halts or fails, or for budget instructions
+vm_status vm_run(vm_t *vm, unsigned long budget)
+{
+    if (vm->failed) {
+	return vm_failed;
+    }
+    if (vm->halt) {
+	return vm_halted;
+    }
+    vm->budget_limited = (budget > 0);
+    vm->budget = budget;
+    TRAP_ERRORS(vm, failed);
+    if (failed) {
+	// write out the output before the error, as the vm program does
+	char_io_flush(&vm->io);
+	if (vm->profiling) {
+	    profile_finish(&vm->profile, false, stack_size(&vm->stack));
+	}
+	vm->failed = true;
+    } else if (machine_run(vm)) {
+	char_io_flush(&vm->io);
+	if (vm->profiling) {
+	    profile_finish(&vm->profile, true, stack_size(&vm->stack));
+	}
+    }
+    END_TRAP();
+    vm->budget_limited = false;
+    if (vm->failed) {
+	return vm_failed;
+    }
+    return vm->halt ? vm_halted : vm_paused;
+}
+
+// Return the number of instructions vm has executed (and counted)
+unsigned long vm_instruction_count(vm_t *vm)
+{
+    return vm->executed;
+}
+
+// Does vm count every instruction it executes?
+bool vm_instructions_counted(vm_t *vm)
+{
+    return machine_counted(vm);
+}
+
+// Return the name of the engine that runs vm's programs
+const char *vm_engine_name(vm_t *vm)
+{
+    return machine_engine_name(vm);
+}
+
+// Return the message of the last error (or "")
+const char *vm_error_message(vm_t *vm)
+{
+    return vm->trap.message;
+}
@@ -0,0 +1,120 @@
+#ifndef _VM_API_H
+#define _VM_API_H
+#include <stddef.h>
+#include <stdbool.h>
+#include "char_io.h"
+
+// The embedding API: the VM as a library, so a program can run
+// PL/0 machine code itself, with any number of VMs at once
+// (each VM used by one thread at a time).
+// A VM is created, loaded with a program (in the text or bytecode
+// format) from a buffer, run (all at once, or a number of instructions
+// at a time), and destroyed.
+// Errors in a program do not end the process, as they do in the vm
+// program; they make vm_run return vm_failed, and vm_error_message
+// returns the message the vm program would print.
+
+// a VM (see machine.h)
+typedef struct vm vm_t;
+
+// the ways the machine can execute instructions once tracing is off
+typedef enum {
+    engine_switch,   // call execute() for each instruction
+    engine_checked,  // threaded, with every stack operation checked
+    engine_threaded, // threaded, unchecked if the program verifies
+    engine_jit       // native code if the program verifies (see jit.h)
+} engine_kind;
+
+// the state of a VM after vm_run
+typedef enum {
+    vm_halted, // a HLT instruction was executed
+    vm_paused, // the budget of instructions ran out
+    vm_failed  // an error stopped the program (see vm_error_message)
+} vm_status;
+
+// Return a new VM, with no program loaded, that does not trace,
+// runs programs in the threaded engine, fuses instructions,
+// and does its character I/O on the standard input and output;
+// return NULL if there is not enough space
+extern vm_t *vm_create();
+
+// Give back all the space used by vm (which may not be used afterwards)
+extern void vm_destroy(vm_t *vm);
+
+// Requires: no program has been loaded into vm
+// Make vm's CHO and CHI instructions use the given hooks (see char_io.h)
+extern void vm_set_io(vm_t *vm, char_io_read_fn read, char_io_write_fn write,
+		      void *arg);
+
+// Use the given engine to run programs; return false (and change
+// nothing) if there is no such engine on this machine (see jit.h)
+extern bool vm_set_engine(vm_t *vm, engine_kind engine);
+
+// Set the maximum height of vm's stack (STACK_DEFAULT_HEIGHT unless set);
+// return false (and change nothing)
+// unless 0 < height <= STACK_CAPACITY (see stack.h)
+extern bool vm_set_stack_height(vm_t *vm, int height);
+
+// Count the instructions vm executes (see vm_instruction_count)
+// if counting is true; counted runs use the checked engine
+// and do not fuse instructions, as runs with a budget do
+extern void vm_set_counting(vm_t *vm, bool counting);
+
+// Limit the programs vm runs to making fuel calls and backward jumps
+// (taken JMP and JPC instructions whose offset is not positive),
+// from now and from each time a program is loaded, or remove the limit
+// if fuel is 0. The limit is checked only at those instructions
+// (in every engine), so it costs nothing in straight-line code.
+// A program that runs out makes vm_run return vm_failed, with a message
+// giving the address of the call or jump (and the number of
+// instructions executed, if they were counted).
+extern void vm_set_fuel(vm_t *vm, unsigned long fuel);
+
+// Requires: buf has size bytes
+// Load the program in buf (in the text or bytecode format) into vm,
+// with an empty stack, ready to run from its first instruction
+// (or the entry point of a bytecode program);
+// the buffer is not used after this returns.
+// Return false if the program is malformed (see vm_error_message).
+extern bool vm_load(vm_t *vm, const char *buf, size_t size);
+
+// Load the program in the file named filename (in the text or bytecode
+// format) into vm, as vm_load does; return false if the file cannot
+// be read or the program is malformed (see vm_error_message)
+extern bool vm_load_file(vm_t *vm, const char *filename);
+
+// Requires: a program has been loaded into vm (and vm_load succeeded)
+// Make vm ready to run its program again from the start, as if it had
+// just been loaded (with an empty stack, and its input read afresh),
+// without reading, checking, or compiling the program again
+// (if that fails, vm_run returns vm_failed)
+extern void vm_restart(vm_t *vm);
+
+// Requires: a program has been loaded into vm
+// Run vm's program until it halts or an error stops it,
+// or (if budget > 0) until it has executed budget more instructions,
+// in which case the next call of vm_run continues where this one stopped.
+// A run with a budget uses the checked engine (whatever vm's engine is),
+// and does not fuse instructions, so that each one is counted.
+// Once the program has halted or failed, vm_run returns the same status
+// without running anything.
+extern vm_status vm_run(vm_t *vm, unsigned long budget);
+
+// Return the number of instructions vm has executed since its program
+// was loaded, in the runs where they were counted (those with a budget,
+// and all runs while counting is on)
+extern unsigned long vm_instruction_count(vm_t *vm);
+
+// Does vm count every instruction it executes (when counting is on,
+// or in the switch engine, which counts them without stepping)?
+extern bool vm_instructions_counted(vm_t *vm);
+
+// Return the name of the engine that runs vm's programs
+// ("checked (stepped)" when each instruction is run on its own,
+// as it is while counting, except in the switch engine)
+extern const char *vm_engine_name(vm_t *vm);
+
+// Return the message of the error that made vm_load return false
+// or vm_run return vm_failed (or "" if there was none)
+extern const char *vm_error_message(vm_t *vm);
+#endif